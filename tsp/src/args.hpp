@@ -20,6 +20,53 @@ struct arguments {
     std::string python_ {};
     std::string algo_option_ {};
 
+    // constructors
+    std::string construction_threads_ {};
+
+    // local search
+    std::string window_ {};
+
+    // lower bound
+    bool gap_ {};
+    std::string gap_epsilon_ {};
+
+    // iterated local search
+    std::string execute_ils_ {};
+    std::string ils_iterations_ {};
+    std::string ils_time_ {};
+    std::string ils_neighbours_ {};
+    std::string ils_kick_length_ {};
+
+    // guided local search
+    std::string execute_gls_ {};
+    std::string gls_iterations_ {};
+    std::string gls_time_ {};
+    std::string gls_neighbours_ {};
+    std::string gls_alpha_ {};
+
+    // ant colony
+    std::string execute_aco_ {};
+    std::string aco_ants_ {};
+    std::string aco_iterations_ {};
+    std::string aco_time_ {};
+    std::string aco_alpha_ {};
+    std::string aco_beta_ {};
+    std::string aco_rho_ {};
+    std::string aco_neighbours_ {};
+    std::string aco_threads_ {};
+    bool aco_no_polish_ {};
+
+    // simulated annealing
+    std::string execute_annealing_ {};
+    std::string sa_schedule_ {};
+    std::string sa_temperature_ {};
+    std::string sa_ratio_ {};
+    std::string sa_epochs_ {};
+    std::string sa_epoch_length_ {};
+    std::string sa_time_ {};
+    std::string sa_replicas_ {};
+    std::string sa_exchange_interval_ {};
+
     // taboo
     std::string execute_taboo_ {};
     std::string taboo_list_length_ {};
@@ -32,11 +79,23 @@ struct arguments {
     std::string population_size_ {};
     std::string generations_number_ {};
     std::string selection_factor_ {};
+    std::string selection_ {};
+    bool rank_selection_ {};
+    bool allow_duplicates_ {};
+    bool diversity_ {};
     std::string genetic_threads_ {};
     std::string arch_btw_ {};
     std::string crossover_chance_ {};
     std::string mutate_chance_ {};
     std::string enchance_chance_ {};
+    std::string enchance_window_ {};
+    std::string improvement_ {};
+    std::string enchance_moves_ {};
+    std::string migration_interval_ {};
+    std::string migrants_ {};
+    std::string topology_ {};
+    std::string replacement_ {};
+    std::string crossover_ {};
 };
 
 namespace args {
@@ -55,18 +114,29 @@ inline auto init_parser(arguments& opts) -> utils::args_helper
         "algorithms:\n"
         "                        k_random - best path from k random permutations, default k = 1\n"
         "                        nearest - greedy nearest neighbour algorithm. chooses always closest city not yet visited. option -x which city comes first\n"
-        "                        nearest_ext - extended nearest neighbour algorithm.\n"
+        "                        nearest_ext - extended nearest neighbour algorithm. runs nearest from every city in parallel, dropping walks worse than the best one so far\n"
+        "                        greedy - greedy matching (multi-fragment): shortest edges first, as long as no city gets degree 3 and no subtour closes. for SYMETRIC TSP\n"
+        "                        savings - Clarke-Wright savings: merges hub -> i -> hub routes by decreasing savings. for SYMETRIC TSP\n"
+        "                        christofides - MST + greedy matching of odd degree cities + shortcut euler tour. for SYMETRIC TSP\n"
+        "                        karp - assignment problem (hungarian) + Karp patching of its subtours into one cycle. for ASYMETRIC TSP\n"
+        "                        held_karp - exact dynamic programming (Held-Karp), optimal path for instances up to 25 cities\n"
+        "                        branch_and_bound - exact parallel branch and bound (1-tree bounds for STSP, assignment bounds for ATSP), prints best value and open nodes every second\n"
+        "                        hilbert - cities in order of Hilbert space-filling curve. O(n log n) on coordinates only (EUC_2D files), without distance matrix unless followed by -t/-G\n"
         "                        2_opt - k_opt where k = 2 :), inverse surrounding general for Asymetric TSP\n"
         "                        2_opt_sym - 2_opt with inverse surrounding optimised for SYMETRIC TSP (won't work with ATSP)\n"
         "                        2_opt_swap - 2-opt with swap surrounding (good for both STSP AND ATSP)\n"
+        "                        balas_simonetti - local search over Balas-Simonetti neighbourhood: best path where every city moves less than k positions, dynamic programming O(n k^2 2^k). good for both STSP AND ATSP\n"
         "\n"
         "options:\n"
         "  -x algoritm_option -> \n"
         "                        k_random: k - amount of permutations\n"
         "                        nearest: id - id of city which comes first (starting from 0)\n"
-        "                        nearest_ext: <no options available>\n"
-        "                        2_opt: one of {asc, rand} - asc (ascending) - 0 1 2 3 .. n-1, rand (random) - <random path :0>\n"
+        "                        nearest_ext: samples - amount of random starting cities, default 0 = every city\n"
+        "                        greedy, savings: k - consider only k nearest neighbours of every city, default 0 = all pairs\n"
+        "                        branch_and_bound: seconds - time limit, default 0 = until optimum is proven\n"
+        "                        2_opt, balas_simonetti: one of {asc, rand, greedy, savings, christofides, karp} - asc (ascending) - 0 1 2 3 .. n-1, rand (random) - <random path :0>, others - constructors above\n"
         "  -h,--help          -> show this help screen\n"
+        "  --window           uint   -> balas_simonetti window k, 2..8, default 6\n"
         "  --threads          -> run in parallel, printing values calculated for each, and best path\n"
         "                     -> 0: all threads available, 1: one thread only, 2 : 2 threads and so on\n"
         "  -d demo_type       -> demo (you should not care about this. it was used only in early development)\n"
@@ -74,9 +144,50 @@ inline auto init_parser(arguments& opts) -> utils::args_helper
         "  -o optimum_value   -> optimal value f(opt) for given problem. if you know it, program will print some additional statistics, how good are its solutions\n"
         "  -p file_path       -> export euclides data to python file (to make some nice visualisations :))\n"
         "                        file_path - python file to write\n"
+        "  --construction_threads     uint   -> amount of threads used by parallel constructors and exact solvers (k_random, nearest_ext, hilbert, christofides, held_karp, branch_and_bound). 0 for all available\n"
+        "  --gap              -> compute lower bound in parallel with the solver (Held-Karp 1-tree for STSP, assignment for ATSP) and print gap of the result to it\n"
+        "  --gap_epsilon      d      -> implies --gap. taboo, genetic and branch_and_bound stop as soon as gap to lower bound in % drops to epsilon\n"
         "  -m                 -> print problem matrix -- you can see what distances between cities look like\n"
         "  -g file_path       -> save problem matrix as atsp fullmatrix file -- useful for generating random problems with atsp tsp problem_type.\n"
         "\n"
+        "  -I ils_version     -> add iterated local search to algorithm pipeline\n"
+        "                        ils -- 2-opt + Or-opt (only Or-opt for ATSP) with don't-look bits, local double-bridge kicks\n"
+        "  --ils_iterations           uint   -> number of kicks, default 100000\n"
+        "  --ils_time                 uint   -> time limit in ms, default 0 = only iterations limit\n"
+        "  --ils_neighbours           uint   -> candidate list length, default 10\n"
+        "  --ils_kick_length          uint   -> max length of segments swapped by double-bridge, default 50\n"
+        "\n"
+        "  -L gls_version     -> add guided local search to algorithm pipeline\n"
+        "                        gls -- 2-opt + Or-opt (only Or-opt for ATSP) with don't-look bits on edge costs augmented with penalties\n"
+        "  --gls_iterations           uint   -> number of penalized local optima, default 100000\n"
+        "  --gls_time                 uint   -> time limit in ms, default 0 = only iterations limit\n"
+        "  --gls_neighbours           uint   -> candidate list length, default 10\n"
+        "  --gls_alpha                d      -> penalty weight lambda = alpha * first local optimum / n, default 0.3\n"
+        "\n"
+        "  -C aco_version     -> add ant colony optimization to algorithm pipeline\n"
+        "                        mmas -- MAX-MIN ant system, ants build tours in parallel from candidate lists\n"
+        "  --aco_ants                 uint   -> ants per iteration, default 25\n"
+        "  --aco_iterations           uint   -> number of iterations, default 2000\n"
+        "  --aco_time                 uint   -> time limit in ms, default 0 = only iterations limit\n"
+        "  --aco_alpha                d      -> pheromone weight, default 1\n"
+        "  --aco_beta                 d      -> distance weight, default 2\n"
+        "  --aco_rho                  d(0,1) -> evaporation, default 0.02\n"
+        "  --aco_neighbours           uint   -> candidate list length, default 20\n"
+        "  --aco_threads              uint   -> threads building tours, default 0 = all available\n"
+        "  --aco_no_polish            -> do not improve best ant of each iteration with 2-opt + Or-opt\n"
+        "\n"
+        "  -A annealing_version -> add simulated annealing to algorithm pipeline\n"
+        "                        sa -- 2-opt + segment moves (segment moves + swap for ATSP) from candidate lists, O(1) delta per move\n"
+        "                        pt -- parallel tempering, replicas on separate threads exchanging temperatures (same as sa with --sa_replicas > 1)\n"
+        "  --sa_schedule              string -> geometric (default), linear, lundy_mees\n"
+        "  --sa_temperature           d      -> starting temperature, default 0 = average uphill move accepted with p = 1/2\n"
+        "  --sa_ratio                 d      -> final temperature = ratio * starting temperature, default 0.001\n"
+        "  --sa_epochs                uint   -> temperature steps, default 1000\n"
+        "  --sa_epoch_length          uint   -> moves per temperature step, default 0 = 100 * n\n"
+        "  --sa_time                  uint   -> time limit in ms, default 0 = only epochs\n"
+        "  --sa_replicas              uint   -> parallel tempering replicas (threads), 1..16, default 1, for pt default 4\n"
+        "  --sa_exchange_interval     uint   -> moves between replica exchange attempts, default 4096\n"
+        "\n"
         "  -t taboo_version   -> add taboosearch to algorithm pipeline\n"
         "                        taboo_asym -- same as in 2_opt\n"
         "                        taboo_sym  -- same as in 2_opt\n"
@@ -87,15 +198,29 @@ inline auto init_parser(arguments& opts) -> utils::args_helper
         "  --taboo_max_back           uint   -> how many times taboo can jump back in a row\n"
         "\n"
         "  -G genetic_version -> add genetic to algorithm pipeline\n"
-        "                        rand_oper -- its the only implemented version :)\n"
+        "                        rand_oper -- one population, children bred in parallel\n"
+        "                        islands   -- island model, one sub-population per thread, elites migrate between islands\n"
+        "                        steady    -- steady state, threads replace individuals in one shared population without generations\n"
         "  --genetic_population_size  uint   -> genotypes in population\n"
         "  --genetic_generations      uint   -> how may generations shall algorithm simulate until it ends\n"
         "  --genetic_selection_factor d[0,1] -> factor of population that has a chance to procreate :)\n"
+        "  --genetic_selection        str    -> roulette (default, alias method, parents drawn by breeding threads), sus (stochastic universal sampling) or tourney\n"
+        "  --genetic_rank_selection          -> roulette and sus weights from linear ranking instead of fitness\n"
         "  --genetic_elitysm_factor   d[0,1] -> factor of population of best genes that survives to next generation\n"
         "  --genetic_threads          uint   -> amount of threads that cooperate for generic algorithm. 0 for all available\n"
         "  --genetic_crossover_chance d[0,1] -> chance that a new genotype will be created as a crossover of two genotypes from procreation pool, instead of copy of one from the same pool\n"
         "  --genetic_mutate_chance    d[0,1] -> chance that newly created genotype has a mutation\n"
         "  --genetic_enchance_chance  d[0,1] -> chance that a new genotype will be magically enchanced :)\n"
+        "  --genetic_improvement      str    -> how genotypes are enchanced: two_opt (default, 2-opt + Or-opt with don't-look bits), or_opt, balas\n"
+        "  --genetic_enchance_moves   uint   -> at most this many improving moves per enchanced genotype, 0 for no limit\n"
+        "  --genetic_enchance_window  uint   -> window of balas_simonetti pass, 2..8. implies --genetic_improvement balas\n"
+        "  --genetic_crossover          str  -> random (default): OX, PMX, CX or ERX at random, eax: edge assembly crossover (use with --genetic_crossover_chance 1 --genetic_mutate_chance 0)\n"
+        "  --genetic_migration_interval uint -> islands: every this many generations an island sends its elites away\n"
+        "  --genetic_migrants           uint -> islands: how many elites migrate at once\n"
+        "  --genetic_topology           str  -> islands: ring (default) or random\n"
+        "  --genetic_replacement        str  -> steady: child replaces tourney (default) loser or the worst individual if it is better\n"
+        "  --genetic_allow_duplicates        -> keep offspring whose tour (as an edge set) is already in the population instead of re-mutating it\n"
+        "  --genetic_diversity               -> print distinct tours and mean edge distance of the population every generation\n"
     };
 
     parser.set_positional({ .write_to = opts.problem_ });
@@ -112,6 +237,43 @@ inline auto init_parser(arguments& opts) -> utils::args_helper
     parser.set_optional({ .write_to = opts.f_opt_, .symbol = "-o" });
     parser.set_optional({ .write_to = opts.python_, .symbol = "-p" });
     parser.set_optional({ .write_to = opts.algo_option_, .symbol = "-x" });
+    parser.set_optional({ .write_to = opts.construction_threads_, .symbol = "--construction_threads" });
+    parser.set_optional({ .write_to = opts.window_, .symbol = "--window" });
+    parser.set_boolean({ .write_to = opts.gap_, .symbol = "--gap" });
+    parser.set_optional({ .write_to = opts.gap_epsilon_, .symbol = "--gap_epsilon" });
+
+    parser.set_optional({ .write_to = opts.execute_ils_, .symbol = "-I" });
+    parser.set_optional({ .write_to = opts.ils_iterations_, .symbol = "--ils_iterations" });
+    parser.set_optional({ .write_to = opts.ils_time_, .symbol = "--ils_time" });
+    parser.set_optional({ .write_to = opts.ils_neighbours_, .symbol = "--ils_neighbours" });
+    parser.set_optional({ .write_to = opts.ils_kick_length_, .symbol = "--ils_kick_length" });
+
+    parser.set_optional({ .write_to = opts.execute_gls_, .symbol = "-L" });
+    parser.set_optional({ .write_to = opts.gls_iterations_, .symbol = "--gls_iterations" });
+    parser.set_optional({ .write_to = opts.gls_time_, .symbol = "--gls_time" });
+    parser.set_optional({ .write_to = opts.gls_neighbours_, .symbol = "--gls_neighbours" });
+    parser.set_optional({ .write_to = opts.gls_alpha_, .symbol = "--gls_alpha" });
+
+    parser.set_optional({ .write_to = opts.execute_aco_, .symbol = "-C" });
+    parser.set_optional({ .write_to = opts.aco_ants_, .symbol = "--aco_ants" });
+    parser.set_optional({ .write_to = opts.aco_iterations_, .symbol = "--aco_iterations" });
+    parser.set_optional({ .write_to = opts.aco_time_, .symbol = "--aco_time" });
+    parser.set_optional({ .write_to = opts.aco_alpha_, .symbol = "--aco_alpha" });
+    parser.set_optional({ .write_to = opts.aco_beta_, .symbol = "--aco_beta" });
+    parser.set_optional({ .write_to = opts.aco_rho_, .symbol = "--aco_rho" });
+    parser.set_optional({ .write_to = opts.aco_neighbours_, .symbol = "--aco_neighbours" });
+    parser.set_optional({ .write_to = opts.aco_threads_, .symbol = "--aco_threads" });
+    parser.set_boolean({ .write_to = opts.aco_no_polish_, .symbol = "--aco_no_polish" });
+
+    parser.set_optional({ .write_to = opts.execute_annealing_, .symbol = "-A" });
+    parser.set_optional({ .write_to = opts.sa_schedule_, .symbol = "--sa_schedule" });
+    parser.set_optional({ .write_to = opts.sa_temperature_, .symbol = "--sa_temperature" });
+    parser.set_optional({ .write_to = opts.sa_ratio_, .symbol = "--sa_ratio" });
+    parser.set_optional({ .write_to = opts.sa_epochs_, .symbol = "--sa_epochs" });
+    parser.set_optional({ .write_to = opts.sa_epoch_length_, .symbol = "--sa_epoch_length" });
+    parser.set_optional({ .write_to = opts.sa_time_, .symbol = "--sa_time" });
+    parser.set_optional({ .write_to = opts.sa_replicas_, .symbol = "--sa_replicas" });
+    parser.set_optional({ .write_to = opts.sa_exchange_interval_, .symbol = "--sa_exchange_interval" });
 
     parser.set_optional({ .write_to = opts.execute_taboo_, .symbol = "-t" });
     parser.set_optional({ .write_to = opts.taboo_list_length_, .symbol = "--taboo_list_length" });
@@ -123,11 +285,23 @@ inline auto init_parser(arguments& opts) -> utils::args_helper
     parser.set_optional({ .write_to = opts.population_size_, .symbol = "--genetic_population_size" });
     parser.set_optional({ .write_to = opts.generations_number_, .symbol = "--genetic_generations" });
     parser.set_optional({ .write_to = opts.selection_factor_, .symbol = "--genetic_selection_factor" });
+    parser.set_optional({ .write_to = opts.selection_, .symbol = "--genetic_selection" });
+    parser.set_boolean({ .write_to = opts.rank_selection_, .symbol = "--genetic_rank_selection" });
+    parser.set_boolean({ .write_to = opts.allow_duplicates_, .symbol = "--genetic_allow_duplicates" });
+    parser.set_boolean({ .write_to = opts.diversity_, .symbol = "--genetic_diversity" });
     parser.set_optional({ .write_to = opts.genetic_threads_, .symbol = "--genetic_threads" });
     parser.set_optional({ .write_to = opts.arch_btw_, .symbol = "--genetic_elitysm_factor" });
     parser.set_optional({ .write_to = opts.crossover_chance_, .symbol = "--genetic_crossover_chance" });
     parser.set_optional({ .write_to = opts.mutate_chance_, .symbol = "--genetic_mutate_chance" });
     parser.set_optional({ .write_to = opts.enchance_chance_, .symbol = "--genetic_enchance_chance" });
+    parser.set_optional({ .write_to = opts.enchance_window_, .symbol = "--genetic_enchance_window" });
+    parser.set_optional({ .write_to = opts.improvement_, .symbol = "--genetic_improvement" });
+    parser.set_optional({ .write_to = opts.enchance_moves_, .symbol = "--genetic_enchance_moves" });
+    parser.set_optional({ .write_to = opts.crossover_, .symbol = "--genetic_crossover" });
+    parser.set_optional({ .write_to = opts.migration_interval_, .symbol = "--genetic_migration_interval" });
+    parser.set_optional({ .write_to = opts.migrants_, .symbol = "--genetic_migrants" });
+    parser.set_optional({ .write_to = opts.topology_, .symbol = "--genetic_topology" });
+    parser.set_optional({ .write_to = opts.replacement_, .symbol = "--genetic_replacement" });
 
     return parser;
 };
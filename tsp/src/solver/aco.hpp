@@ -0,0 +1,318 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "local_search.hpp"
+#include "lower_bound.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+#include "solver/prdprinter.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace tsp::solver::aco {
+
+// bez poprawy najlepszej trasy przez tyle iteracji feromon wraca do tau_max
+constexpr uint64_t stagnation_iterations = 250;
+// co tyle iteracji feromon odklada najlepsza trasa od resetu zamiast najlepszej z iteracji
+constexpr uint64_t global_best_interval = 10;
+
+struct parameters {
+    std::size_t ants_ { 25 };
+    uint64_t iterations_ { 2000 };
+    uint64_t time_limit_ { 0 }; // milisekundy, 0 -> tylko limit iteracji
+    double alpha_ { 1. }; // waga feromonu
+    double beta_ { 2. }; // waga odleglosci
+    double rho_ { 0.02 }; // parowanie
+    double p_best_ { 0.05 }; // p zbudowania najlepszej trasy przy zbieznosci -- wyznacza tau_min
+    std::size_t neighbours_ { 20 }; // mrowki wybieraja z list kandydatow
+    std::size_t threads_ { 0 }; // 0 -> tyle ile rdzeni
+    bool polish_ { true }; // 2-opt + Or-opt najlepszej mrowki z iteracji
+};
+
+namespace detail {
+
+    inline auto uniform(std::mt19937_64& rng) -> double
+    {
+        return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @brief parowanie i przyciecie do [minimum, maximum] w jednej petli po ciaglej pamieci
+     * bez rozgalezien i zaleznosci miedzy iteracjami -- kompilator zamienia ja na mnozenie i min/max na calych rejestrach
+     */
+    inline void evaporate(double* __restrict tau, std::size_t count, double keep, double minimum, double maximum)
+    {
+        for (std::size_t i {}; i < count; ++i) {
+            tau[i] = std::min(std::max(tau[i] * keep, minimum), maximum);
+        }
+    }
+
+    /**
+     * @brief choice = tau^alpha * eta^beta dla krawedzi z list kandydatow, tau juz zebrane do ciaglej tablicy
+     */
+    inline void choice_info(double* __restrict choice, const double* __restrict tau, const double* __restrict eta, std::size_t count, double alpha)
+    {
+        if (alpha == 1.) {
+            for (std::size_t i {}; i < count; ++i) {
+                choice[i] = tau[i] * eta[i];
+            }
+        } else {
+            for (std::size_t i {}; i < count; ++i) {
+                choice[i] = std::pow(tau[i], alpha) * eta[i];
+            }
+        }
+    }
+
+    struct ant {
+        std::mt19937_64 rng_;
+        std::vector<uint32_t> tour_ {};
+        std::vector<uint8_t> visited_ {};
+        std::vector<double> weights_ {};
+        config::value_type length_ {};
+
+        ant(std::size_t size, std::size_t k, uint64_t seed)
+            : rng_ { seed }
+            , tour_(size)
+            , visited_(size)
+            , weights_(k)
+        {
+        }
+
+        /**
+         * @brief trasa od losowego miasta, kolejne miasto losowane z nieodwiedzonych kandydatow proporcjonalnie do choice
+         * jezeli wszyscy kandydaci sa juz odwiedzeni -- najblizsze nieodwiedzone miasto
+         */
+        void build(const ds::heap_matrix<config::value_type>& matrix, const neighbour_lists& neighbours, const std::vector<double>& choice)
+        {
+            const auto size = tour_.size();
+            const auto k = neighbours.k();
+
+            std::fill(visited_.begin(), visited_.end(), 0);
+            auto city = static_cast<uint32_t>(rng_() % size);
+            tour_[0] = city;
+            visited_[city] = 1;
+            length_ = 0;
+
+            for (std::size_t step = 1; step < size; ++step) {
+                const auto candidates = neighbours.at(city);
+                const auto* row = choice.data() + city * k;
+
+                double sum {};
+                for (std::size_t j {}; j < k; ++j) {
+                    weights_[j] = visited_[candidates[j]] ? 0. : row[j];
+                    sum += weights_[j];
+                }
+
+                uint32_t next = std::numeric_limits<uint32_t>::max();
+                if (sum > 0.) {
+                    auto r = uniform(rng_) * sum;
+                    for (std::size_t j {}; j < k; ++j) {
+                        if (weights_[j] > 0.) {
+                            next = candidates[j];
+                            if (r < weights_[j]) {
+                                break;
+                            }
+                            r -= weights_[j];
+                        }
+                    }
+                } else {
+                    auto best = std::numeric_limits<config::value_type>::max();
+                    for (uint32_t other {}; other < size; ++other) {
+                        if (!visited_[other] && matrix.at(city, other) < best) {
+                            best = matrix.at(city, other);
+                            next = other;
+                        }
+                    }
+                }
+
+                tour_[step] = next;
+                visited_[next] = 1;
+                length_ += matrix.at(city, next);
+                city = next;
+            }
+            length_ += matrix.at(city, tour_[0]);
+        }
+    };
+}
+
+/**
+ * @brief MAX-MIN Ant System: mrowki budujace trasy rownolegle z list kandydatow, kazda z wlasnym generatorem
+ * feromon w heap_matrix<double> o tym samym ukladzie co macierz kosztow (dla STSP zapisywane sa oba kierunki),
+ * parowanie to jedna petla po calej pamieci, a prawdopodobienstwa wyboru sa liczone raz na iteracje dla krawedzi z list
+ * feromon odklada najlepsza mrowka z iteracji (co global_best_interval -- najlepsza od resetu), wartosci trzymane
+ * w [tau_min, tau_max], a po stagnacji feromon jest resetowany
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& starting_path, const parameters& params = {})
+    -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 8) {
+        return starting_path;
+    }
+    if (params.ants_ == 0 || params.rho_ <= 0. || params.rho_ >= 1. || params.p_best_ <= 0. || params.p_best_ >= 1.) {
+        throw std::runtime_error { "aco:: potrzebna co najmniej jedna mrowka, rho i p_best z zakresu (0, 1)" };
+    }
+
+    const neighbour_lists neighbours { matrix, params.neighbours_ };
+    const auto k = neighbours.k();
+    const bool symmetric = is_symmetric(matrix);
+
+    // eta^beta nie zmienia sie w trakcie, liczone raz dla krawedzi z list
+    std::vector<double> eta(size * k);
+    for (std::size_t city {}; city < size; ++city) {
+        const auto candidates = neighbours.at(city);
+        for (std::size_t j {}; j < k; ++j) {
+            const auto distance = std::max(static_cast<double>(matrix.at(city, candidates[j])), 0.5);
+            eta[city * k + j] = std::pow(1. / distance, params.beta_);
+        }
+    }
+
+    auto best_value = calculate_value(matrix, starting_path);
+    std::vector<uint32_t> best_tour(starting_path.begin(), starting_path.end() - 1);
+
+    auto tau_max = 1. / (params.rho_ * static_cast<double>(best_value));
+    auto tau_min = 0.;
+    auto update_bounds = [&]() {
+        tau_max = 1. / (params.rho_ * static_cast<double>(best_value));
+        const auto root = std::pow(params.p_best_, 1. / static_cast<double>(size));
+        tau_min = std::min(tau_max, tau_max * (1. - root) / ((static_cast<double>(size) / 2. - 1.) * root));
+    };
+    update_bounds();
+
+    ds::heap_matrix<double> pheromone { size };
+    std::fill(pheromone.data(), pheromone.data() + size * size, tau_max);
+
+    std::vector<double> gathered(size * k);
+    std::vector<double> choice(size * k);
+
+    std::random_device dev {};
+    std::vector<detail::ant> ants {};
+    ants.reserve(params.ants_);
+    for (std::size_t a {}; a < params.ants_; ++a) {
+        ants.emplace_back(size, k, (static_cast<uint64_t>(dev()) << 32) | dev());
+    }
+
+    const auto threads = std::min<std::size_t>(params.ants_,
+        params.threads_ != 0 ? params.threads_ : std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+    utils::thread_pool pool { threads };
+    std::vector<std::future<void>> futures {};
+
+    const local_search::matrix_cost cost { matrix };
+    local_search::optimizer optimizer { neighbours, cost, symmetric };
+
+    auto deposit = [&](const std::vector<uint32_t>& tour, config::value_type length) {
+        const auto amount = 1. / static_cast<double>(std::max<config::value_type>(length, 1));
+        for (std::size_t i {}; i < size; ++i) {
+            const auto from = tour[i];
+            const auto to = tour[i + 1 == size ? 0 : i + 1];
+            pheromone.at(from, to) += amount;
+            if (symmetric) {
+                pheromone.at(to, from) += amount;
+            }
+        }
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    // najlepsza trasa od ostatniego resetu -- po resecie mrowki zaczynaja od tras duzo gorszych od najlepszej
+    auto restart_value = std::numeric_limits<config::value_type>::max();
+    std::vector<uint32_t> restart_tour {};
+    uint64_t last_improvement {};
+    for (uint64_t iteration {}; iteration < params.iterations_; ++iteration) {
+        if (params.time_limit_ != 0 && std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(params.time_limit_)) {
+            break;
+        }
+
+        for (std::size_t city {}; city < size; ++city) {
+            const auto candidates = neighbours.at(city);
+            for (std::size_t j {}; j < k; ++j) {
+                gathered[city * k + j] = pheromone.at(city, candidates[j]);
+            }
+        }
+        detail::choice_info(choice.data(), gathered.data(), eta.data(), size * k, params.alpha_);
+
+        futures.clear();
+        for (std::size_t t {}; t < threads; ++t) {
+            futures.push_back(pool.queue([&, t]() {
+                for (auto a = t; a < ants.size(); a += threads) {
+                    ants[a].build(matrix, neighbours, choice);
+                }
+            }));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+
+        auto& iteration_best = *std::min_element(ants.begin(), ants.end(), [](auto const& l, auto const& r) {
+            return l.length_ < r.length_;
+        });
+
+        if (params.polish_) {
+            config::path_type path(iteration_best.tour_.begin(), iteration_best.tour_.end());
+            path.push_back(path[0]);
+
+            local_search::tour t { path };
+            optimizer.push_all(t);
+            iteration_best.length_ = static_cast<config::value_type>(static_cast<local_search::delta_type>(iteration_best.length_) + optimizer.run(t));
+            for (std::size_t i {}; i < size; ++i) {
+                iteration_best.tour_[i] = t.at(i);
+            }
+        }
+
+        if (iteration_best.length_ < restart_value) {
+            restart_value = iteration_best.length_;
+            restart_tour = iteration_best.tour_;
+            last_improvement = iteration;
+        }
+        if (iteration_best.length_ < best_value) {
+            best_value = iteration_best.length_;
+            best_tour = iteration_best.tour_;
+            update_bounds();
+
+            auto instance = prd_printer::instance();
+            if (instance) {
+                instance->print(iteration, best_value);
+            }
+            if (lower_bound::should_stop(best_value)) {
+                break;
+            }
+        }
+
+        if (iteration - last_improvement > stagnation_iterations) {
+            std::fill(pheromone.data(), pheromone.data() + size * size, tau_max);
+            restart_value = std::numeric_limits<config::value_type>::max();
+            last_improvement = iteration;
+            continue;
+        }
+
+        // po parowaniu tau <= (1 - rho) tau_max, a depozyt to 1/L <= rho tau_max, wiec tau_max nie zostanie przekroczone
+        detail::evaporate(pheromone.data(), size * size, 1. - params.rho_, tau_min, tau_max);
+        if (iteration % global_best_interval == global_best_interval - 1) {
+            deposit(restart_tour, restart_value);
+        } else {
+            deposit(iteration_best.tour_, iteration_best.length_);
+        }
+    }
+
+    config::path_type path {};
+    path.reserve(size + 1);
+    const auto start = std::find(best_tour.begin(), best_tour.end(), static_cast<uint32_t>(starting_path[0]));
+    path.insert(path.end(), start, best_tour.end());
+    path.insert(path.end(), best_tour.begin(), start);
+    path.push_back(path[0]);
+
+    return path;
+}
+
+}
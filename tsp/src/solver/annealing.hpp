@@ -0,0 +1,435 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "local_search.hpp"
+#include "lower_bound.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+#include "solver/prdprinter.hpp"
+#include "utils/atomic_min.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tsp::solver::annealing {
+
+enum class schedule {
+    geometric, // T_k = T_0 * a^k
+    linear, // T_k = T_0 * (1 - k / epochs * (1 - ratio))
+    lundy_mees, // T_k+1 = T_k / (1 + b * T_k)
+};
+
+// drabina temperatur jest trzymana w jednym 64-bitowym atomiku po 4 bity na szczebel
+constexpr std::size_t max_replicas = 16;
+// stosunek temperatury najgoretszego i najzimniejszego szczebla w parallel tempering
+constexpr double ladder_spread = 10.;
+
+struct parameters {
+    schedule schedule_ { schedule::geometric };
+    double initial_temperature_ { 0. }; // 0 -> dobierana tak, zeby sredni ruch pod gore przechodzil z p = 1/2
+    double final_ratio_ { 1e-3 }; // T_koncowa = final_ratio_ * T_0
+    uint64_t epochs_ { 1000 };
+    uint64_t epoch_length_ { 0 }; // ruchy na epoke, 0 -> 100 * n
+    uint64_t time_limit_ { 0 }; // milisekundy, 0 -> tylko epoki. z limitem chlodzenie idzie wg czasu az do jego konca
+    std::size_t neighbours_ { 8 };
+    std::size_t replicas_ { 1 }; // > 1 -> parallel tempering, kazda replika na swoim threadzie
+    uint64_t exchange_interval_ { 4096 }; // ruchy miedzy probami zamiany temperatur
+};
+
+namespace detail {
+
+    inline auto uniform(std::mt19937_64& rng) -> double
+    {
+        return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+    }
+
+    enum class move_kind : uint8_t {
+        none,
+        two_opt,
+        exchange,
+        segment,
+    };
+
+    struct move {
+        move_kind kind_ { move_kind::none };
+        local_search::delta_type delta_ {};
+        uint32_t x_ {};
+        uint32_t y_ {};
+        uint32_t length_ {};
+    };
+
+    /**
+     * @brief jeden lancuch: losowy ruch z list kandydatow, zmiana kosztu w O(1), zastosowanie w miejscu
+     * STSP -- 2-opt i przeniesienie segmentu, ATSP -- zamiana dwoch miast i przeniesienie segmentu
+     */
+    class chain {
+        const ds::heap_matrix<config::value_type>& matrix_;
+        const neighbour_lists& neighbours_;
+        bool symmetric_;
+
+        local_search::tour tour_;
+        local_search::delta_type value_;
+        std::mt19937_64 rng_;
+
+        local_search::delta_type best_value_;
+        config::path_type best_path_;
+
+        auto cost(uint32_t from, uint32_t to) const -> local_search::delta_type
+        {
+            return static_cast<local_search::delta_type>(matrix_.at(from, to));
+        }
+
+    public:
+        chain(const ds::heap_matrix<config::value_type>& matrix, const neighbour_lists& neighbours, bool symmetric,
+            const config::path_type& path, uint64_t seed)
+            : matrix_ { matrix }
+            , neighbours_ { neighbours }
+            , symmetric_ { symmetric }
+            , tour_ { path }
+            , value_ { static_cast<local_search::delta_type>(calculate_value(matrix, path)) }
+            , rng_ { seed }
+            , best_value_ { value_ }
+            , best_path_ { path }
+        {
+        }
+
+        auto value() const -> local_search::delta_type
+        {
+            return value_;
+        }
+
+        auto best_value() const -> local_search::delta_type
+        {
+            return best_value_;
+        }
+
+        auto best_path() const -> config::path_type const&
+        {
+            return best_path_;
+        }
+
+        auto rng() -> std::mt19937_64&
+        {
+            return rng_;
+        }
+
+        auto propose() -> move
+        {
+            const auto n = tour_.size();
+            const auto bits = rng_();
+            const auto a = static_cast<uint32_t>((bits >> 32) % n);
+            const auto c = neighbours_.at(a)[(bits & 0xffff) % neighbours_.k()];
+
+            if ((bits >> 16) & 1) {
+                if (symmetric_) {
+                    // a b ... c d -> a c ... b d
+                    const auto b = tour_.next(a);
+                    const auto d = tour_.next(c);
+                    if (c == b || d == a) {
+                        return {};
+                    }
+
+                    return { move_kind::two_opt, cost(a, c) + cost(b, d) - cost(a, b) - cost(c, d), b, c };
+                }
+
+                // zamiana next(a) z c -- powstaje krawedz a -> c
+                const auto x = tour_.next(a);
+                const auto y = c;
+                if (x == y) {
+                    return {};
+                }
+
+                const auto px = tour_.prev(x), nx = tour_.next(x);
+                const auto py = tour_.prev(y), ny = tour_.next(y);
+                local_search::delta_type delta {};
+                if (nx == y) {
+                    delta = cost(px, y) + cost(y, x) + cost(x, ny) - cost(px, x) - cost(x, y) - cost(y, ny);
+                } else if (ny == x) {
+                    delta = cost(py, x) + cost(x, y) + cost(y, nx) - cost(py, y) - cost(y, x) - cost(x, nx);
+                } else {
+                    delta = cost(px, y) + cost(y, nx) + cost(py, x) + cost(x, ny)
+                        - cost(px, x) - cost(x, nx) - cost(py, y) - cost(y, ny);
+                }
+                return { move_kind::exchange, delta, x, y };
+            }
+
+            // segment c .. (1-3 miasta) miedzy a i next(a)
+            const auto length = static_cast<uint32_t>(1 + ((bits >> 17) & 3) % 3);
+            auto last = c;
+            for (uint32_t i = 1; i < length; ++i) {
+                last = tour_.next(last);
+            }
+            const auto p = tour_.prev(c);
+            const auto q = tour_.next(last);
+            const auto e = tour_.next(a);
+            if (a == p || tour_.distance(c, a) < length) {
+                return {};
+            }
+
+            return { move_kind::segment, cost(p, q) + cost(a, c) + cost(last, e) - cost(p, c) - cost(last, q) - cost(a, e), c, a, length };
+        }
+
+        void apply(move const& m)
+        {
+            switch (m.kind_) {
+            case move_kind::two_opt:
+                tour_.reverse(tour_.position(m.x_), tour_.position(m.y_));
+                break;
+            case move_kind::exchange:
+                tour_.exchange(tour_.position(m.x_), tour_.position(m.y_));
+                break;
+            case move_kind::segment:
+                tour_.move_segment(m.x_, m.length_, m.y_);
+                break;
+            case move_kind::none:
+                return;
+            }
+            value_ += m.delta_;
+        }
+
+        /**
+         * @brief moves krokow Metropolisa w stalej temperaturze
+         */
+        void run(double temperature, uint64_t moves)
+        {
+            // powyzej 30 T prawdopodobienstwo jest ponizej 1e-13 -- szkoda losowania
+            const double cutoff = 30. * temperature;
+
+            for (uint64_t i {}; i < moves; ++i) {
+                const auto m = propose();
+                if (m.kind_ == move_kind::none) {
+                    continue;
+                }
+
+                if (m.delta_ > 0) {
+                    if (static_cast<double>(m.delta_) > cutoff || uniform(rng_) >= std::exp(-static_cast<double>(m.delta_) / temperature)) {
+                        continue;
+                    }
+                    // minimum gubi sie dopiero przy ruchu pod gore -- wtedy kopia trasy, a nie przy kazdym zejsciu
+                    save_best();
+                }
+
+                apply(m);
+            }
+
+            save_best();
+        }
+
+        void save_best()
+        {
+            if (value_ < best_value_) {
+                best_value_ = value_;
+                best_path_ = tour_.to_path(0);
+            }
+        }
+    };
+
+    /**
+     * @brief temperatura startowa: sredni koszt ruchu pod gore z proby, przyjmowany z prawdopodobienstwem 1/2
+     */
+    inline auto initial_temperature(chain& c) -> double
+    {
+        double sum {};
+        std::size_t count {};
+        for (std::size_t i {}; i < 10000 && count < 1000; ++i) {
+            auto m = c.propose();
+            if (m.kind_ != move_kind::none && m.delta_ > 0) {
+                sum += static_cast<double>(m.delta_);
+                ++count;
+            }
+        }
+
+        return count == 0 ? 1. : sum / static_cast<double>(count) / std::log(2.);
+    }
+
+    /**
+     * @param progress 0 na poczatku, 1 na koncu chlodzenia
+     */
+    inline auto temperature_at(parameters const& params, double initial, double progress) -> double
+    {
+        progress = std::clamp(progress, 0., 1.);
+
+        switch (params.schedule_) {
+        case schedule::geometric:
+            return initial * std::pow(params.final_ratio_, progress);
+        case schedule::linear:
+            return initial * (1. - progress * (1. - params.final_ratio_));
+        case schedule::lundy_mees:
+            // T_k = T_0 / (1 + b k T_0) z b dobranym tak, zeby na koncu dojsc do final_ratio_ * T_0
+            return initial / (1. + progress * (1. / params.final_ratio_ - 1.));
+        }
+
+        return initial;
+    }
+
+    inline auto rung_of(uint64_t ladder, std::size_t replica, std::size_t replicas) -> std::size_t
+    {
+        for (std::size_t rung {}; rung < replicas; ++rung) {
+            if (((ladder >> (4 * rung)) & 0xf) == replica) {
+                return rung;
+            }
+        }
+
+        return 0;
+    }
+}
+
+/**
+ * @brief symulowane wyzarzanie: losowe ruchy z list kandydatow oceniane tylko zmiana kosztu i stosowane w miejscu
+ * z replicas_ > 1 -- parallel tempering: repliki na osobnych threadach w temperaturach z harmonogramu rozlozonych
+ * geometrycznie (ladder_spread), ktore co exchange_interval_ ruchow probuja zamienic sie szczeblami. drabina (szczebel -> replika) to jeden
+ * atomik, wiec zamiana to CAS bez blokad, a replika tylko odczytuje swoj aktualny szczebel
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& starting_path, const parameters& params = {})
+    -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 8) {
+        return starting_path;
+    }
+    if (params.replicas_ == 0 || params.replicas_ > max_replicas) {
+        throw std::runtime_error { "annealing:: liczba replik musi byc z zakresu [1, " + std::to_string(max_replicas) + "]" };
+    }
+
+    const neighbour_lists neighbours { matrix, params.neighbours_ };
+    const bool symmetric = is_symmetric(matrix);
+    const uint64_t epoch_length = params.epoch_length_ == 0 ? 100 * size : params.epoch_length_;
+    const auto replicas = params.replicas_;
+
+    std::random_device dev {};
+    std::vector<detail::chain> chains {};
+    chains.reserve(replicas);
+    for (std::size_t r {}; r < replicas; ++r) {
+        chains.emplace_back(matrix, neighbours, symmetric, starting_path, (static_cast<uint64_t>(dev()) << 32) | dev());
+    }
+
+    const double initial = params.initial_temperature_ > 0. ? params.initial_temperature_ : detail::initial_temperature(chains[0]);
+
+    std::atomic<config::value_type> best_value { calculate_value(matrix, starting_path) };
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> evaluated { 0 };
+
+    const auto started = std::chrono::steady_clock::now();
+    auto out_of_time = [&]() {
+        return params.time_limit_ != 0 && std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(params.time_limit_);
+    };
+    auto progress = [&](uint64_t moves) {
+        if (params.time_limit_ != 0) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count() / static_cast<double>(params.time_limit_);
+        }
+        return static_cast<double>(moves / epoch_length) / static_cast<double>(std::max<uint64_t>(1, params.epochs_ - 1));
+    };
+    const uint64_t total = params.time_limit_ != 0 ? std::numeric_limits<uint64_t>::max() : params.epochs_ * epoch_length;
+
+    auto report = [&](detail::chain const& c, uint64_t epoch) {
+        const auto value = static_cast<config::value_type>(c.best_value());
+        if (utils::atomic_fetch_min(best_value, value)) {
+            auto instance = prd_printer::instance();
+            if (instance) {
+                instance->print(epoch, value);
+            }
+        }
+        if (lower_bound::should_stop(best_value.load()) || out_of_time()) {
+            stop = true;
+        }
+    };
+
+    if (replicas == 1) {
+        auto& c = chains[0];
+        for (uint64_t done {}; done < total && !stop; done += epoch_length) {
+            c.run(detail::temperature_at(params, initial, progress(done)), epoch_length);
+            evaluated += epoch_length;
+            report(c, done / epoch_length);
+        }
+    } else {
+        // cala drabina jest chlodzona harmonogramem, a szczeble sa rozlozone geometrycznie na jeden rzad wielkosci
+        std::vector<double> spread(replicas);
+        for (std::size_t rung {}; rung < replicas; ++rung) {
+            spread[rung] = std::pow(ladder_spread, -static_cast<double>(rung) / static_cast<double>(replicas - 1));
+        }
+
+        // szczebel r (0 -- najgoretszy) -> replika w bitach 4r..4r+3
+        uint64_t identity {};
+        for (std::size_t rung {}; rung < replicas; ++rung) {
+            identity |= static_cast<uint64_t>(rung) << (4 * rung);
+        }
+        std::atomic<uint64_t> ladder { identity };
+        std::vector<std::atomic<local_search::delta_type>> energies(replicas);
+        for (std::size_t r {}; r < replicas; ++r) {
+            energies[r] = chains[r].value();
+        }
+
+        const uint64_t interval = std::max<uint64_t>(1, params.exchange_interval_);
+
+        auto replica = [&](std::size_t r) {
+            auto& c = chains[r];
+            for (uint64_t done {}; done < total && !stop.load(std::memory_order_relaxed); done += interval) {
+                const auto epoch_temperature = detail::temperature_at(params, initial, progress(done));
+                auto rung = detail::rung_of(ladder.load(std::memory_order_acquire), r, replicas);
+                c.run(epoch_temperature * spread[rung], interval);
+                energies[r].store(c.value(), std::memory_order_relaxed);
+                evaluated.fetch_add(interval, std::memory_order_relaxed);
+                report(c, done / epoch_length);
+
+                // zamiana z sasiednim zimniejszym szczeblem: p = min(1, exp((E_i - E_j)(1/T_i - 1/T_j)))
+                if (rung + 1 < replicas) {
+                    auto current = ladder.load(std::memory_order_acquire);
+                    rung = detail::rung_of(current, r, replicas);
+                    if (rung + 1 < replicas) {
+                        const auto other = (current >> (4 * (rung + 1))) & 0xf;
+                        const auto exponent = static_cast<double>(energies[r].load(std::memory_order_relaxed) - energies[other].load(std::memory_order_relaxed))
+                            * (1. / spread[rung] - 1. / spread[rung + 1]) / epoch_temperature;
+                        if (exponent >= 0. || detail::uniform(c.rng()) < std::exp(exponent)) {
+                            auto swapped = current & ~((uint64_t { 0xff }) << (4 * rung));
+                            swapped |= (other << (4 * rung)) | (static_cast<uint64_t>(r) << (4 * (rung + 1)));
+                            ladder.compare_exchange_strong(current, swapped, std::memory_order_acq_rel);
+                        }
+                    }
+                }
+            }
+        };
+
+        utils::thread_pool pool { replicas };
+        std::vector<std::future<void>> futures {};
+        for (std::size_t r {}; r < replicas; ++r) {
+            futures.push_back(pool.queue([&replica, r]() { replica(r); }));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "simulated_annealing: " << evaluated.load() << " ocen ruchow, "
+              << static_cast<uint64_t>(static_cast<double>(evaluated.load()) / std::max(elapsed, 1e-9)) << " / s\n";
+
+    auto best = std::min_element(chains.begin(), chains.end(), [](auto const& l, auto const& r) {
+        return l.best_value() < r.best_value();
+    });
+    if (best->best_value() >= static_cast<local_search::delta_type>(calculate_value(matrix, starting_path))) {
+        return starting_path;
+    }
+
+    // od tego samego miasta co trasa startowa
+    auto path = best->best_path();
+    path.pop_back();
+    std::rotate(path.begin(), std::find(path.begin(), path.end(), starting_path[0]), path.end());
+    path.push_back(path[0]);
+
+    return path;
+}
+
+}
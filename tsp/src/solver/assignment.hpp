@@ -0,0 +1,117 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tsp::solver::assignment {
+
+using cost_type = int64_t;
+
+// koszt zakazanego przypisania (np miasto samo do siebie) -- duzy, ale tak zeby suma n takich sie nie przepelnila
+constexpr cost_type forbidden = std::numeric_limits<cost_type>::max() / (1 << 16);
+
+struct result {
+    std::vector<uint32_t> successor_ {}; // wiersz -> przypisana kolumna
+    cost_type value_ {};
+
+    // zmienne dualne, cost(r, c) - row_potential_[r] - column_potential_[c] >= 0 to koszt zredukowany
+    std::vector<cost_type> row_potential_ {};
+    std::vector<cost_type> column_potential_ {};
+};
+
+/**
+ * @brief problem przydzialu (wegierski z potencjalami, najkrotsze sciezki powiekszajace) O(n^3)
+ *
+ * @param size n -- macierz kosztow n x n
+ * @param cost cost(row, column), forbidden dla zakazanych
+ */
+template <typename Cost>
+inline auto solve(std::size_t size, Cost const& cost) -> result
+{
+    constexpr cost_type infinity = std::numeric_limits<cost_type>::max();
+
+    // indeksowanie od 1, kolumna 0 to sztuczny korzen
+    std::vector<cost_type> u(size + 1, 0);
+    std::vector<cost_type> v(size + 1, 0);
+    std::vector<std::size_t> row_of(size + 1, 0);
+    std::vector<std::size_t> way(size + 1, 0);
+
+    std::vector<cost_type> min_v(size + 1);
+    std::vector<uint8_t> used(size + 1);
+    for (std::size_t row = 1; row <= size; ++row) {
+        row_of[0] = row;
+        std::size_t column0 = 0;
+        std::fill(min_v.begin(), min_v.end(), infinity);
+        std::fill(used.begin(), used.end(), 0);
+
+        do {
+            used[column0] = 1;
+            std::size_t row0 = row_of[column0];
+            cost_type delta = infinity;
+            std::size_t column1 = 0;
+
+            for (std::size_t column = 1; column <= size; ++column) {
+                if (used[column]) {
+                    continue;
+                }
+
+                cost_type current = cost(row0 - 1, column - 1) - u[row0] - v[column];
+                if (current < min_v[column]) {
+                    min_v[column] = current;
+                    way[column] = column0;
+                }
+                if (min_v[column] < delta) {
+                    delta = min_v[column];
+                    column1 = column;
+                }
+            }
+
+            for (std::size_t column = 0; column <= size; ++column) {
+                if (used[column]) {
+                    u[row_of[column]] += delta;
+                    v[column] -= delta;
+                } else {
+                    min_v[column] -= delta;
+                }
+            }
+            column0 = column1;
+        } while (row_of[column0] != 0);
+
+        do {
+            std::size_t column1 = way[column0];
+            row_of[column0] = row_of[column1];
+            column0 = column1;
+        } while (column0 != 0);
+    }
+
+    result assigned {};
+    assigned.successor_.resize(size);
+    for (std::size_t column = 1; column <= size; ++column) {
+        assigned.successor_[row_of[column] - 1] = static_cast<uint32_t>(column - 1);
+    }
+    for (std::size_t row {}; row < size; ++row) {
+        assigned.value_ += cost(row, assigned.successor_[row]);
+    }
+    assigned.row_potential_.assign(u.begin() + 1, u.end());
+    assigned.column_potential_.assign(v.begin() + 1, v.end());
+
+    return assigned;
+}
+
+/**
+ * @brief przydzial dla macierzy odleglosci -- kazde miasto dostaje nastepnika, petle i -> i sa zakazane
+ * rozwiazanie to zbior rozlacznych cykli, a jego koszt jest dolnym ograniczeniem ATSP
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix) -> result
+{
+    return solve(matrix.size(), [&matrix](std::size_t from, std::size_t to) -> cost_type {
+        return from == to ? forbidden : static_cast<cost_type>(matrix.at(from, to));
+    });
+}
+
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tsp::solver::balas_simonetti {
+
+constexpr std::size_t default_window = 6;
+// stany na pozycje rosna jak C(2k-2, k-1) * (2k-1) -- dla 8 to juz ~50KB na kazde miasto
+constexpr std::size_t max_window = 8;
+
+namespace detail {
+
+    /**
+     * @brief stany DP dla okna k: maska miast z okna [p-k+1, p+k-1] (2k-1 bitow) juz ustawionych na pozycjach 0..p
+     * miasto p-k+1 musi juz stac (najdalej na pozycji p), wiec bit 0 jest zawsze ustawiony i ustawionych bitow jest dokladnie k
+     */
+    struct window_states {
+        std::size_t k_ {};
+        std::size_t bits_ {};
+        std::vector<uint32_t> masks_ {};
+        std::vector<int32_t> id_ {}; // maska -> indeks w masks_, -1 dla niedozwolonych
+
+        explicit window_states(std::size_t k)
+            : k_ { k }
+            , bits_ { 2 * k - 1 }
+            , id_(std::size_t { 1 } << bits_, -1)
+        {
+            for (uint32_t mask {}; mask < id_.size(); ++mask) {
+                if ((mask & 1) && static_cast<std::size_t>(std::popcount(mask)) == k_) {
+                    id_[mask] = static_cast<int32_t>(masks_.size());
+                    masks_.push_back(mask);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief jedno przejscie Balas-Simonetti: najlepsza trasa, w ktorej kazde miasto jest przesuniete o mniej niz k pozycji
+     * (dokladniej: jezeli j >= i + k, to miasto z pozycji i zostaje przed miastem z pozycji j). path[0] stoi w miejscu
+     * DP po pozycjach, O(n k^2 2^k) czasu
+     *
+     * @param path zamknieta trasa, nadpisywana jezeli znaleziono lepsza
+     * @return wartosc trasy po przejsciu
+     */
+    inline auto improve(const ds::heap_matrix<config::value_type>& matrix, config::path_type& path, std::size_t k) -> config::value_type
+    {
+        constexpr auto infinity = std::numeric_limits<config::value_type>::max();
+
+        const auto n = path.size() - 1;
+        const auto current_value = calculate_value(matrix, path);
+        if (n < 4 || k < 2) {
+            return current_value;
+        }
+
+        const window_states states { k };
+        const auto bits = states.bits_;
+        const auto layer = states.masks_.size() * bits;
+
+        // ostatnio ustawione miasto jest trzymane jako przesuniecie w oknie
+        std::vector<config::value_type> current(layer, infinity);
+        std::vector<config::value_type> next(layer, infinity);
+        std::vector<uint8_t> previous_last(n * layer, 0);
+
+        // pozycja 0: miasta "przed" trasa sa udawane jako ustawione, miasto 0 stoi na przesunieciu k-1
+        const uint32_t full = (uint32_t { 1 } << k) - 1;
+        current[states.id_[full] * bits + (k - 1)] = 0;
+
+        auto index_of = [k](std::size_t p, std::size_t offset) -> int64_t {
+            return static_cast<int64_t>(p) - static_cast<int64_t>(k) + 1 + static_cast<int64_t>(offset);
+        };
+
+        for (std::size_t p {}; p + 1 < n; ++p) {
+            std::fill(next.begin(), next.end(), infinity);
+
+            for (std::size_t m {}; m < states.masks_.size(); ++m) {
+                const auto mask = states.masks_[m];
+                const auto shifted = mask >> 1;
+
+                for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+                    const auto last = static_cast<std::size_t>(std::countr_zero(rest));
+                    const auto value = current[m * bits + last];
+                    if (value == infinity) {
+                        continue;
+                    }
+                    const auto from = path[index_of(p, last)];
+
+                    for (std::size_t offset {}; offset < bits; ++offset) {
+                        if (shifted & (uint32_t { 1 } << offset)) {
+                            continue;
+                        }
+                        const auto city = index_of(p + 1, offset);
+                        if (city >= static_cast<int64_t>(n)) {
+                            break;
+                        }
+
+                        const uint32_t placed = shifted | (uint32_t { 1 } << offset);
+                        if (!(placed & 1)) {
+                            continue;
+                        }
+                        // wszystko co jest o k i wiecej pozycji wczesniej musi juz stac
+                        if (offset >= k && (~placed & ((uint32_t { 1 } << (offset - k + 1)) - 1))) {
+                            continue;
+                        }
+
+                        const auto at = states.id_[placed] * bits + offset;
+                        const auto candidate = value + matrix.at(from, path[city]);
+                        if (candidate < next[at]) {
+                            next[at] = candidate;
+                            previous_last[(p + 1) * layer + at] = static_cast<uint8_t>(last);
+                        }
+                    }
+                }
+            }
+
+            std::swap(current, next);
+        }
+
+        // na ostatniej pozycji okno [n-k, n+k-2] ma ustawione dokladnie pierwsze k miast
+        auto best = infinity;
+        std::size_t best_last {};
+        for (std::size_t last {}; last < k; ++last) {
+            const auto value = current[states.id_[full] * bits + last];
+            if (value == infinity || index_of(n - 1, last) < 0) {
+                continue;
+            }
+
+            const auto total = value + matrix.at(path[index_of(n - 1, last)], path[0]);
+            if (total < best) {
+                best = total;
+                best_last = last;
+            }
+        }
+
+        if (best >= current_value) {
+            return current_value;
+        }
+
+        config::path_type improved(n + 1);
+        improved[0] = improved[n] = path[0];
+        uint32_t mask = full;
+        std::size_t last = best_last;
+        for (std::size_t p = n - 1; p > 0; --p) {
+            improved[p] = path[index_of(p, last)];
+
+            const auto before = previous_last[p * layer + states.id_[mask] * bits + last];
+            mask = ((mask & ~(uint32_t { 1 } << last)) << 1) | 1;
+            last = before;
+        }
+
+        path = std::move(improved);
+        return best;
+    }
+
+    inline void check_window(std::size_t k)
+    {
+        if (k < 2 || k > max_window) {
+            throw std::runtime_error { "balas_simonetti:: okno musi byc z zakresu [2, " + std::to_string(max_window) + "]" };
+        }
+    }
+}
+
+/**
+ * @brief przejscie sasiedztwa Balas-Simonetti dla jednej trasy (np jako ulepszenie w genetycznym)
+ */
+inline auto improve(const ds::heap_matrix<config::value_type>& matrix, config::path_type& path, std::size_t k = default_window) -> config::value_type
+{
+    detail::check_window(k);
+    return detail::improve(matrix, path, k);
+}
+
+/**
+ * @brief local search jak two_opt, tylko z sasiedztwem Balas-Simonetti -- wykladniczo wiele tras na przejscie
+ * miasto startowe w DP sie nie rusza, wiec po utknieciu trasa jest jeszcze raz przegladana obrocona o polowe
+ *
+ * @param k okno -- miasto moze sie przesunac o mniej niz k pozycji
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& starting_path, std::size_t k = default_window)
+    -> config::path_type
+{
+    detail::check_window(k);
+
+    config::path_type path = starting_path;
+    if (path.size() < 5) {
+        return path;
+    }
+
+    const auto n = path.size() - 1;
+    auto value = calculate_value(matrix, path);
+    bool rotated {};
+    while (true) {
+        auto improved = detail::improve(matrix, path, k);
+        if (improved < value) {
+            value = improved;
+            rotated = false;
+            continue;
+        }
+        if (rotated) {
+            break;
+        }
+
+        path.pop_back();
+        std::rotate(path.begin(), path.begin() + n / 2, path.end());
+        path.push_back(path[0]);
+        rotated = true;
+    }
+
+    // z powrotem od miasta startowego
+    path.pop_back();
+    std::rotate(path.begin(), std::find(path.begin(), path.end(), starting_path[0]), path.end());
+    path.push_back(path[0]);
+
+    return path;
+}
+
+}
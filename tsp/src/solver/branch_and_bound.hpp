@@ -0,0 +1,437 @@
+#pragma once
+
+#include "assignment.hpp"
+#include "config.hpp"
+#include "lower_bound.hpp"
+#include "matrix.hpp"
+#include "one_tree.hpp"
+#include "path.hpp"
+#include "solver.hpp"
+#include "solver/prdprinter.hpp"
+#include "surroundings.hpp"
+#include "utils/atomic_min.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/work_stealing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace tsp::solver::branch_and_bound {
+
+struct parameters {
+    std::size_t threads_ { 0 }; // 0 -> wszystkie dostepne
+    uint64_t time_limit_ { 0 }; // sekundy, 0 -> bez limitu (wtedy wynik jest optymalny)
+};
+
+namespace detail {
+
+    struct node {
+        std::vector<uint32_t> path_ {}; // od miasta 0, bez powrotu
+        config::value_type cost_ {};
+        double bound_ {}; // ograniczenie odziedziczone po rodzicu -- pozwala odciac bez liczenia, jezeli incumbent sie poprawil
+        std::vector<double> pi_ {}; // kary Lagrange'a rodzica (tylko STSP), start dla ascentu w tym wezle
+    };
+
+    // pamiec robocza workera -- zeby nie allokowac przy kazdym wezle
+    struct workspace {
+        std::vector<uint8_t> visited_ {};
+        std::vector<uint32_t> remaining_ {};
+        std::vector<uint32_t> subset_ {};
+        std::vector<double> key_ {};
+        std::vector<uint32_t> parent_ {};
+        std::vector<uint8_t> in_tree_ {};
+        std::vector<uint32_t> degree_ {};
+        std::vector<uint32_t> neighbours_ {};
+        std::vector<double> best_pi_ {};
+        std::vector<uint32_t> rows_ {};
+        std::vector<uint32_t> columns_ {};
+        std::vector<uint32_t> completion_ {}; // optymalne dokonczenie, jezeli relaksacja okazala sie trasa
+    };
+
+    struct bound_result {
+        double value_ {};
+        bool exact_ {}; // relaksacja jest juz dopuszczalna -- completion_ to najlepsze dokonczenie
+    };
+
+    /**
+     * @brief STSP: dokonczenie trasy to sciezka last -> R -> 0, czyli drzewo rozpinajace R + {last, 0}
+     * ze stopniami 2 w R i 1 na koncach. z karami pi: koszt >= MST_pi - 2 * suma_R pi - pi_last - pi_0
+     * kilka krokow subgradientu (od kar rodzica) dociaga ograniczenie do konkretnego poddrzewa, pi zostaje najlepsze
+     */
+    inline auto tree_bound(
+        const ds::heap_matrix<config::value_type>& matrix,
+        std::vector<double>& pi,
+        uint32_t last,
+        config::value_type upper,
+        std::size_t iterations,
+        workspace& ws)
+        -> bound_result
+    {
+        auto& subset = ws.subset_;
+        subset.assign(ws.remaining_.begin(), ws.remaining_.end());
+        subset.push_back(last);
+        subset.push_back(0);
+
+        const auto size = subset.size();
+        const std::size_t remaining = size - 2;
+        auto target = [remaining](std::size_t i) -> double {
+            return i < remaining ? 2. : 1.;
+        };
+
+        bound_result best { -std::numeric_limits<double>::infinity(), false };
+        ws.best_pi_ = pi;
+
+        double step_factor = 1.;
+        for (std::size_t iteration {}; iteration < iterations; ++iteration) {
+            auto& key = ws.key_;
+            auto& parent = ws.parent_;
+            auto& in_tree = ws.in_tree_;
+            auto& degree = ws.degree_;
+            key.assign(size, std::numeric_limits<double>::infinity());
+            parent.assign(size, 0);
+            in_tree.assign(size, 0);
+            degree.assign(size, 0);
+
+            double tree {};
+            std::size_t added = size - 1;
+            in_tree[added] = 1;
+            for (std::size_t step = 1; step < size; ++step) {
+                std::size_t closest = size;
+                for (std::size_t i {}; i < size; ++i) {
+                    if (in_tree[i]) {
+                        continue;
+                    }
+                    auto value = static_cast<double>(matrix.at(subset[added], subset[i])) + pi[subset[added]] + pi[subset[i]];
+                    if (value < key[i]) {
+                        key[i] = value;
+                        parent[i] = static_cast<uint32_t>(added);
+                    }
+                    if (closest == size || key[i] < key[closest]) {
+                        closest = i;
+                    }
+                }
+                in_tree[closest] = 1;
+                tree += key[closest];
+                ++degree[closest];
+                ++degree[parent[closest]];
+                added = closest;
+            }
+
+            double penalties {};
+            double norm {};
+            for (std::size_t i {}; i < size; ++i) {
+                penalties += target(i) * pi[subset[i]];
+                norm += (degree[i] - target(i)) * (degree[i] - target(i));
+            }
+            const double value = tree - penalties;
+
+            if (value > best.value_) {
+                best.value_ = value;
+                ws.best_pi_ = pi;
+            }
+
+            if (norm == 0.) {
+                // drzewo z dwoma liscmi last i 0 to sciezka -- najtansze dokonczenie, dalej nie ma czego szukac
+                best.exact_ = true;
+                best.value_ = value;
+                ws.best_pi_ = pi;
+
+                // sasiedzi w drzewie (stopnie <= 2) i przejscie od last
+                auto& neighbours = ws.neighbours_;
+                neighbours.assign(2 * size, static_cast<uint32_t>(size));
+                auto link = [&](std::size_t a, std::size_t b) {
+                    neighbours[2 * a + (neighbours[2 * a] == size ? 0 : 1)] = static_cast<uint32_t>(b);
+                };
+                for (std::size_t i {}; i + 1 < size; ++i) {
+                    link(i, parent[i]);
+                    link(parent[i], i);
+                }
+
+                ws.completion_.clear();
+                std::size_t previous = size, current = size - 2;
+                while (current != size - 1) {
+                    if (current != size - 2) {
+                        ws.completion_.push_back(subset[current]);
+                    }
+                    auto next = neighbours[2 * current] != previous ? neighbours[2 * current] : neighbours[2 * current + 1];
+                    previous = current;
+                    current = next;
+                }
+                break;
+            }
+            if (std::ceil(value - 1e-7) >= static_cast<double>(upper)) {
+                break;
+            }
+
+            double step = step_factor * (static_cast<double>(upper) - value) / norm;
+            for (std::size_t i {}; i < size; ++i) {
+                pi[subset[i]] += step * (degree[i] - target(i));
+            }
+            step_factor *= 0.9;
+        }
+
+        pi = ws.best_pi_;
+        return best;
+    }
+
+    /**
+     * @brief ATSP: dokonczenie przypisuje kazdemu z {last} + R nastepnika z R + {0} -- to problem przydzialu
+     * najpierw tanie ograniczenie z minimow wierszy, pelny przydzial tylko jak ono nie wystarczy
+     *
+     * @param child_bounds wyjscie -- dla kazdego miasta z R ograniczenie dziecka last -> city z kosztow zredukowanych
+     */
+    inline auto assignment_bound(
+        const ds::heap_matrix<config::value_type>& matrix,
+        uint32_t last,
+        config::value_type limit,
+        std::vector<double>& child_bounds,
+        workspace& ws)
+        -> bound_result
+    {
+        auto& rows = ws.rows_;
+        auto& columns = ws.columns_;
+        rows.assign(1, last);
+        rows.insert(rows.end(), ws.remaining_.begin(), ws.remaining_.end());
+        columns.assign(ws.remaining_.begin(), ws.remaining_.end());
+        columns.push_back(0);
+
+        const auto size = rows.size();
+        auto cost = [&](std::size_t r, std::size_t c) -> assignment::cost_type {
+            if (rows[r] == columns[c] || (r == 0 && c + 1 == size && size > 1)) {
+                return assignment::forbidden;
+            }
+            return static_cast<assignment::cost_type>(matrix.at(rows[r], columns[c]));
+        };
+
+        config::value_type row_minimums {};
+        for (std::size_t r {}; r < size; ++r) {
+            auto minimum = assignment::forbidden;
+            for (std::size_t c {}; c < size; ++c) {
+                minimum = std::min(minimum, cost(r, c));
+            }
+            row_minimums += static_cast<config::value_type>(minimum);
+        }
+        if (row_minimums >= limit) {
+            return { static_cast<double>(row_minimums), false };
+        }
+
+        auto assigned = assignment::solve(size, cost);
+
+        child_bounds.resize(size - 1);
+        for (std::size_t c {}; c + 1 < size; ++c) {
+            auto reduced = cost(0, c) - assigned.row_potential_[0] - assigned.column_potential_[c];
+            child_bounds[c] = static_cast<double>(assigned.value_ + reduced);
+        }
+
+        // przydzial bez podcykli to juz sciezka last -> ... -> 0
+        ws.completion_.clear();
+        std::size_t row = 0;
+        for (std::size_t step {}; step < size; ++step) {
+            auto column = assigned.successor_[row];
+            if (column + 1 == size) {
+                break;
+            }
+            ws.completion_.push_back(columns[column]);
+            row = column + 1;
+        }
+
+        return { static_cast<double>(assigned.value_), ws.completion_.size() + 1 == size };
+    }
+}
+
+/**
+ * @brief dokladny branch and bound w glab, startujacy z incumbenta nearest_ext + two_opt
+ *
+ * galaz to przedluzenie czesciowej trasy od miasta 0 o jedno nieodwiedzone miasto (najblizsze najpierw).
+ * ograniczenia: STSP -- drzewo rozpinajace z karami Lagrange'a (ascent 1-drzewa w korzeniu, potem kilka krokow
+ * w kazdym wezle od kar rodzica), ATSP -- problem przydzialu na pozostalych miastach, a jego koszty zredukowane
+ * odcinaja dzieci bez liczenia. jezeli relaksacja jest juz sciezka, wezel konczy sie od razu jej dokonczeniem.
+ * poddrzewa sa rozkladane przez kolejki z kradzieza,
+ * incumbent jest wspolnym atomikiem. co sekunde wypisuje najlepsza wartosc i liczbe otwartych wezlow
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const parameters& params = {}) -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 4) {
+        return nearest_ext(matrix);
+    }
+
+    const bool symmetric = is_symmetric(matrix);
+
+    config::path_type best_path = nearest_ext(matrix, { .threads_ = params.threads_ });
+    best_path = symmetric ? two_opt<surroundings::symetric_inverse>(matrix, best_path)
+                          : two_opt<surroundings::asymetric_inverse>(matrix, best_path);
+
+    std::atomic<config::value_type> incumbent { calculate_value(matrix, best_path) };
+    std::mutex best_mutex {};
+
+    std::vector<double> pi {};
+    if (symmetric) {
+        pi = one_tree::held_karp_bound(matrix, incumbent.load(), 1000 + 20 * size).pi_;
+    }
+
+    std::size_t threads = params.threads_ == 0 ? std::thread::hardware_concurrency() : params.threads_;
+    threads = std::max<std::size_t>(1, threads);
+
+    // ascent w wezle startuje od kar rodzica, wiec wystarcza kilka krokow
+    constexpr std::size_t node_iterations = 25;
+
+    utils::work_stealing_queues<detail::node> queues { threads };
+    queues.push(0, detail::node { { 0 }, 0, 0., pi });
+
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> processed { 0 };
+
+    auto improve = [&](std::vector<uint32_t> const& path, config::value_type value) {
+        if (!utils::atomic_fetch_min(incumbent, value)) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> l(best_mutex);
+        if (value <= incumbent.load()) {
+            best_path.assign(path.begin(), path.end());
+            best_path.push_back(0);
+        }
+
+        auto instance = prd_printer::instance();
+        if (instance) {
+            instance->print(processed.load(std::memory_order_relaxed), value);
+        }
+    };
+
+    auto worker = [&](std::size_t id) {
+        detail::workspace ws {};
+        ws.visited_.resize(size);
+        std::vector<double> child_bounds {};
+        std::vector<uint32_t> completed {};
+
+        while (!stop.load(std::memory_order_relaxed) && queues.pending() > 0) {
+            auto popped = queues.pop(id);
+            if (!popped) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            auto& current = *popped;
+            processed.fetch_add(1, std::memory_order_relaxed);
+
+            const auto last = current.path_.back();
+            const auto limit = incumbent.load(std::memory_order_relaxed);
+            if (std::ceil(current.bound_ - 1e-7) >= static_cast<double>(limit)) {
+                queues.done();
+                continue;
+            }
+
+            std::fill(ws.visited_.begin(), ws.visited_.end(), 0);
+            for (auto city : current.path_) {
+                ws.visited_[city] = 1;
+            }
+            ws.remaining_.clear();
+            for (uint32_t city {}; city < size; ++city) {
+                if (!ws.visited_[city]) {
+                    ws.remaining_.push_back(city);
+                }
+            }
+
+            if (ws.remaining_.empty()) {
+                auto value = current.cost_ + matrix.at(last, 0);
+                if (value < limit) {
+                    improve(current.path_, value);
+                }
+                queues.done();
+                continue;
+            }
+
+            // korzen -- dokonczenie to caly cykl, a nie sciezka, wiec tu sie nie ogranicza
+            detail::bound_result bound { static_cast<double>(current.cost_), false };
+            child_bounds.clear();
+            if (current.path_.size() > 1) {
+                if (symmetric) {
+                    bound = detail::tree_bound(matrix, current.pi_, last, limit - current.cost_, node_iterations, ws);
+                } else {
+                    bound = detail::assignment_bound(matrix, last, limit - current.cost_, child_bounds, ws);
+                }
+                bound.value_ += static_cast<double>(current.cost_);
+            }
+
+            if (std::ceil(bound.value_ - 1e-7) >= static_cast<double>(limit)) {
+                queues.done();
+                continue;
+            }
+
+            if (bound.exact_) {
+                completed = current.path_;
+                completed.insert(completed.end(), ws.completion_.begin(), ws.completion_.end());
+                improve(completed, calculate_value(matrix, config::path_type(completed.begin(), completed.end())) + matrix.at(completed.back(), 0));
+                queues.done();
+                continue;
+            }
+
+            // najblizsze ma byc zdjete pierwsze, a worker bierze z konca
+            std::vector<std::pair<double, uint32_t>> children {};
+            children.reserve(ws.remaining_.size());
+            for (std::size_t i {}; i < ws.remaining_.size(); ++i) {
+                auto city = ws.remaining_[i];
+                auto child_bound = child_bounds.empty() ? bound.value_ : static_cast<double>(current.cost_) + child_bounds[i];
+                if (current.cost_ + matrix.at(last, city) < limit && std::ceil(child_bound - 1e-7) < static_cast<double>(limit)) {
+                    children.emplace_back(child_bound, city);
+                }
+            }
+            std::sort(children.begin(), children.end(), [&](auto const& l, auto const& r) {
+                return matrix.at(last, l.second) > matrix.at(last, r.second);
+            });
+
+            for (auto const& [child_bound, city] : children) {
+                detail::node child { current.path_, current.cost_ + matrix.at(last, city), child_bound, current.pi_ };
+                child.path_.push_back(city);
+                queues.push(id, std::move(child));
+            }
+
+            queues.done();
+        }
+    };
+
+    utils::thread_pool pool { threads };
+    std::vector<std::future<void>> futures {};
+    for (std::size_t id {}; id < threads; ++id) {
+        futures.push_back(pool.queue([&worker, id]() { worker(id); }));
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    bool gap_reached {};
+    for (auto& future : futures) {
+        while (future.wait_for(std::chrono::seconds(1)) != std::future_status::ready) {
+            std::cout << "branch_and_bound: best = " << incumbent.load() << ", open nodes = " << queues.pending() << "\n";
+
+            auto elapsed = std::chrono::steady_clock::now() - started;
+            if (params.time_limit_ != 0 && elapsed >= std::chrono::seconds(params.time_limit_)) {
+                stop = true;
+            }
+            if (lower_bound::should_stop(incumbent.load())) {
+                stop = true;
+                gap_reached = true;
+            }
+        }
+    }
+
+    if (gap_reached) {
+        std::cout << "branch_and_bound: przerwano, luka do dolnego ograniczenia ponizej epsilon\n";
+    } else if (stop) {
+        std::cout << "branch_and_bound: przerwano po limicie czasu, trasa moze nie byc optymalna\n";
+    }
+
+    return best_path;
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace tsp::solver {
+
+/**
+ * @brief listy kandydatow -- dla kazdego miasta k najblizszych (wg matrix.at(city, other)), rosnaco
+ * trzymane w jednym ciaglym bloku size * k, zeby przegladanie sasiadow nie skakalo po pamieci
+ */
+class neighbour_lists {
+    std::vector<uint32_t> raw_ {};
+    std::size_t size_ {};
+    std::size_t k_ {};
+
+public:
+    neighbour_lists() = default;
+
+    neighbour_lists(const ds::heap_matrix<config::value_type>& matrix, std::size_t k)
+        : size_ { matrix.size() }
+        , k_ { std::min<std::size_t>(k, matrix.size() > 0 ? matrix.size() - 1 : 0) }
+    {
+        raw_.resize(size_ * k_);
+
+        std::vector<uint32_t> others {};
+        others.reserve(size_);
+        for (std::size_t city {}; city < size_; ++city) {
+            others.clear();
+            for (std::size_t other {}; other < size_; ++other) {
+                if (other != city) {
+                    others.push_back(static_cast<uint32_t>(other));
+                }
+            }
+
+            auto closer = [&matrix, city](uint32_t l, uint32_t r) {
+                auto lv = matrix.at(city, l);
+                auto rv = matrix.at(city, r);
+                return lv < rv || (lv == rv && l < r);
+            };
+            std::nth_element(others.begin(), others.begin() + k_, others.end(), closer);
+            std::sort(others.begin(), others.begin() + k_, closer);
+
+            std::copy(others.begin(), others.begin() + k_, raw_.begin() + city * k_);
+        }
+    }
+
+    auto size() const -> std::size_t
+    {
+        return size_;
+    }
+
+    auto k() const -> std::size_t
+    {
+        return k_;
+    }
+
+    auto at(std::size_t city) const -> std::span<const uint32_t>
+    {
+        return { raw_.data() + city * k_, k_ };
+    }
+};
+
+}
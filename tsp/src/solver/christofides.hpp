@@ -0,0 +1,239 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tsp::solver {
+
+namespace detail {
+
+    /**
+     * @brief minimalne drzewo rozpinajace -- Prim O(n^2) prosto po macierzy
+     * dla duzych n relaksacja kluczy i szukanie minimum sa dzielone na kawalki miedzy thready,
+     * ktore synchronizuja sie jedna bariera na iteracje (jej completion wybiera globalne minimum)
+     *
+     * @return parent[v] dla kazdego v, korzen (miasto 0) ma parent == siebie
+     */
+    inline auto minimum_spanning_tree(const ds::heap_matrix<config::value_type>& matrix, std::size_t threads = 0) -> std::vector<uint32_t>
+    {
+        constexpr auto infinity = std::numeric_limits<config::value_type>::max();
+        const auto size = matrix.size();
+
+        std::vector<uint32_t> parent(size, 0);
+        if (size == 0) {
+            return parent;
+        }
+
+        std::vector<config::value_type> key(size, infinity);
+        std::vector<uint8_t> in_tree(size, 0);
+
+        threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+        // kawalek ponizej ~1k miast nie pokrywa kosztu bariery
+        threads = std::max<std::size_t>(1, std::min<std::size_t>(threads, size / 1024));
+
+        struct local_best {
+            config::value_type value_ { infinity };
+            uint32_t city_ {};
+        };
+        std::vector<local_best> chunk_best(threads);
+
+        uint32_t added {};
+        in_tree[added] = 1;
+
+        auto relax = [&](std::size_t chunk) {
+            const std::size_t first = size * chunk / threads;
+            const std::size_t last = size * (chunk + 1) / threads;
+
+            local_best best {};
+            for (std::size_t city = first; city < last; ++city) {
+                if (in_tree[city]) {
+                    continue;
+                }
+
+                auto value = matrix.at(added, city);
+                if (value < key[city]) {
+                    key[city] = value;
+                    parent[city] = added;
+                }
+                if (key[city] < best.value_) {
+                    best = { key[city], static_cast<uint32_t>(city) };
+                }
+            }
+            chunk_best[chunk] = best;
+        };
+
+        auto pick = [&]() noexcept {
+            local_best best {};
+            for (auto const& candidate : chunk_best) {
+                if (candidate.value_ < best.value_ || (candidate.value_ == best.value_ && candidate.city_ < best.city_)) {
+                    best = candidate;
+                }
+            }
+
+            added = best.city_;
+            in_tree[added] = 1;
+        };
+
+        if (threads == 1) {
+            for (std::size_t step = 1; step < size; ++step) {
+                relax(0);
+                pick();
+            }
+            return parent;
+        }
+
+        std::barrier sync { static_cast<std::ptrdiff_t>(threads), pick };
+        utils::thread_pool pool { threads };
+        std::vector<std::future<void>> futures {};
+        for (std::size_t chunk {}; chunk < threads; ++chunk) {
+            futures.push_back(pool.queue([&, chunk]() {
+                for (std::size_t step = 1; step < size; ++step) {
+                    relax(chunk);
+                    sync.arrive_and_wait();
+                }
+            }));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+
+        return parent;
+    }
+
+    /**
+     * @brief zachlanne skojarzenie doskonale: pary rosnaco wg odleglosci, bierzemy jezeli oba miasta sa jeszcze wolne
+     */
+    inline auto greedy_matching(const ds::heap_matrix<config::value_type>& matrix, const std::vector<uint32_t>& cities)
+        -> std::vector<std::pair<uint32_t, uint32_t>>
+    {
+        struct pair_edge {
+            config::value_type value_ {};
+            uint32_t a_ {};
+            uint32_t b_ {};
+        };
+
+        std::vector<pair_edge> pairs {};
+        pairs.reserve(cities.size() * (cities.size() - 1) / 2);
+        for (std::size_t i {}; i < cities.size(); ++i) {
+            for (std::size_t j = i + 1; j < cities.size(); ++j) {
+                pairs.push_back({ matrix.at(cities[i], cities[j]), cities[i], cities[j] });
+            }
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const pair_edge& l, const pair_edge& r) {
+            return l.value_ < r.value_ || (l.value_ == r.value_ && (l.a_ < r.a_ || (l.a_ == r.a_ && l.b_ < r.b_)));
+        });
+
+        std::vector<uint8_t> matched(matrix.size(), 0);
+        std::vector<std::pair<uint32_t, uint32_t>> matching {};
+        matching.reserve(cities.size() / 2);
+        for (auto const& p : pairs) {
+            if (!matched[p.a_] && !matched[p.b_]) {
+                matched[p.a_] = matched[p.b_] = 1;
+                matching.emplace_back(p.a_, p.b_);
+            }
+        }
+
+        return matching;
+    }
+}
+
+/**
+ * @brief w stylu Christofidesa: MST + skojarzenie wierzcholkow nieparzystego stopnia + cykl Eulera ze skrotami
+ * skojarzenie jest zachlanne (zamiast minimalnego), wiec gwarancja 3/2 przechodzi w praktyczne ~15-20% ponad optimum
+ * dla symetrycznego, metrycznego TSP
+ *
+ * @param threads thready dla Prima, 0 -> wszystkie dostepne
+ */
+inline auto christofides(const ds::heap_matrix<config::value_type>& matrix, std::size_t threads = 0) -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 3) {
+        config::path_type path(size);
+        for (std::size_t i {}; i < size; ++i) {
+            path[i] = i;
+        }
+        if (size > 0) {
+            path.push_back(0);
+        }
+        return path;
+    }
+
+    auto parent = detail::minimum_spanning_tree(matrix, threads);
+
+    // multigraf: krawedzie MST + skojarzenia, jako listy sasiedztwa indeksow krawedzi
+    std::vector<std::pair<uint32_t, uint32_t>> edges {};
+    edges.reserve(size + size / 2);
+    std::vector<uint32_t> degree(size, 0);
+    for (uint32_t city = 1; city < size; ++city) {
+        edges.emplace_back(city, parent[city]);
+        ++degree[city];
+        ++degree[parent[city]];
+    }
+
+    std::vector<uint32_t> odd {};
+    for (uint32_t city {}; city < size; ++city) {
+        if (degree[city] % 2 == 1) {
+            odd.push_back(city);
+        }
+    }
+    for (auto const& edge : detail::greedy_matching(matrix, odd)) {
+        edges.push_back(edge);
+        ++degree[edge.first];
+        ++degree[edge.second];
+    }
+
+    std::vector<std::vector<uint32_t>> incident(size);
+    for (uint32_t city {}; city < size; ++city) {
+        incident[city].reserve(degree[city]);
+    }
+    for (uint32_t e {}; e < edges.size(); ++e) {
+        incident[edges[e].first].push_back(e);
+        incident[edges[e].second].push_back(e);
+    }
+
+    // Hierholzer iteracyjnie, od razu ze skrotami -- miasto trafia do trasy przy pierwszym zdjeciu ze stosu
+    std::vector<uint8_t> used(edges.size(), 0);
+    std::vector<std::size_t> next_edge(size, 0);
+    std::vector<uint8_t> visited(size, 0);
+    std::vector<uint32_t> stack { 0 };
+
+    config::path_type path {};
+    path.reserve(size + 1);
+    while (!stack.empty()) {
+        auto city = stack.back();
+
+        auto& e = next_edge[city];
+        while (e < incident[city].size() && used[incident[city][e]]) {
+            ++e;
+        }
+
+        if (e == incident[city].size()) {
+            stack.pop_back();
+            if (!visited[city]) {
+                visited[city] = 1;
+                path.push_back(city);
+            }
+            continue;
+        }
+
+        auto edge = incident[city][e];
+        used[edge] = 1;
+        stack.push_back(edges[edge].first == city ? edges[edge].second : edges[edge].first);
+    }
+    path.push_back(path[0]);
+
+    return path;
+}
+
+}
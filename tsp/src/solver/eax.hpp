@@ -0,0 +1,489 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tsp::solver::eax {
+
+using delta_type = int64_t;
+
+constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+// najwiecej tylu AB-cykli jest sprawdzanych dla jednej pary rodzicow -- dziecko powstaje z najlepszego
+constexpr std::size_t max_tries = 30;
+
+/**
+ * @brief dane wspolne dla wszystkich krzyzowan jednego uruchomienia -- listy kandydatow do laczenia podtras
+ */
+struct context {
+    const ds::heap_matrix<config::value_type>& matrix_;
+    neighbour_lists neighbours_;
+    bool symmetric_ {};
+
+    context(const ds::heap_matrix<config::value_type>& matrix, std::size_t k, bool symmetric)
+        : matrix_ { matrix }
+        , neighbours_ { matrix, k }
+        , symmetric_ { symmetric }
+    {
+    }
+
+    auto cost(uint32_t from, uint32_t to) const -> delta_type
+    {
+        return static_cast<delta_type>(matrix_.at(from, to));
+    }
+};
+
+/**
+ * @brief bufory jednego watku -- trasa trzymana jako sasiedztwo: link_[v] to dwaj sasiedzi (STSP)
+ * albo {poprzednik, nastepnik} (ATSP), wiec zastosowanie E-setu to tylko podmiana krawedzi w O(dlugosc cyklu)
+ */
+struct buffers {
+    std::vector<std::array<uint32_t, 2>> link_ {};
+    std::vector<std::array<uint32_t, 2>> link_b_ {};
+    std::vector<std::array<uint32_t, 2>> rest_a_ {}; // krawedzie A spoza B jeszcze nie uzyte w AB-cyklach
+    std::vector<std::array<uint32_t, 2>> rest_b_ {};
+    std::vector<std::array<uint32_t, 2>> walk_index_ {}; // pozycja wierzcholka w walk_ o danej parzystosci
+    std::vector<uint32_t> walk_ {};
+    std::vector<uint32_t> cycles_ {}; // AB-cykle jeden za drugim: wierzcholki od pierwszej krawedzi A, bez powtorzenia
+    std::vector<uint32_t> offsets_ {};
+    std::vector<uint32_t> subtour_ {};
+    std::vector<uint32_t> sizes_ {};
+    std::vector<uint32_t> members_ {};
+    std::vector<uint32_t> marks_ {};
+    uint32_t stamp_ {};
+    std::vector<std::pair<uint32_t, std::array<uint32_t, 2>>> log_ {}; // stare sasiedztwa do wycofania proby
+
+    /**
+     * @brief zapamietuje sasiedztwo v przed zmiana
+     */
+    auto touch(uint32_t v) -> std::array<uint32_t, 2>&
+    {
+        log_.emplace_back(v, link_[v]);
+        return link_[v];
+    }
+
+    void undo()
+    {
+        for (auto it = log_.rbegin(); it != log_.rend(); ++it) {
+            link_[it->first] = it->second;
+        }
+        log_.clear();
+    }
+
+    void resize(std::size_t cities)
+    {
+        if (link_.size() == cities) {
+            return;
+        }
+        link_.resize(cities);
+        link_b_.resize(cities);
+        rest_a_.resize(cities);
+        rest_b_.resize(cities);
+        walk_index_.resize(cities);
+        subtour_.resize(cities);
+        marks_.assign(cities, 0);
+        stamp_ = 0;
+        walk_.reserve(2 * cities + 1);
+        cycles_.reserve(2 * cities);
+        members_.reserve(cities);
+        log_.reserve(4 * cities);
+    }
+
+    auto next_stamp() -> uint32_t
+    {
+        if (++stamp_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            stamp_ = 1;
+        }
+        return stamp_;
+    }
+};
+
+namespace detail {
+
+    inline void replace(std::array<uint32_t, 2>& link, uint32_t from, uint32_t to)
+    {
+        link[link[0] == from ? 0 : 1] = to;
+    }
+
+    inline void take(std::array<uint32_t, 2>& rest, uint32_t city)
+    {
+        if (rest[0] == city) {
+            rest[0] = rest[1];
+        }
+        rest[1] = none;
+    }
+
+    inline auto count(std::array<uint32_t, 2> const& rest) -> uint32_t
+    {
+        return (rest[0] != none) + (rest[1] != none);
+    }
+
+    inline auto pick(std::array<uint32_t, 2> const& rest, auto& rng) -> uint32_t
+    {
+        return rest[1] != none && (rng() & 1) ? rest[1] : rest[0];
+    }
+
+    /**
+     * @brief AB-cykle STSP: z krawedzi A i B bez wspolnych budowany jest naprzemienny spacer z losowym wyborem krawedzi,
+     * a gdy wierzcholek powtorzy sie na pozycji tej samej parzystosci, odcinek miedzy nimi jest gotowym AB-cyklem
+     */
+    inline void ab_cycles_undirected(std::span<const uint32_t> a, std::span<const uint32_t> b, buffers& buf, auto& rng)
+    {
+        const auto size = a.size();
+        for (std::size_t i {}; i < size; ++i) {
+            buf.link_[a[i]] = { a[i == 0 ? size - 1 : i - 1], a[i + 1 == size ? 0 : i + 1] };
+            buf.link_b_[b[i]] = { b[i == 0 ? size - 1 : i - 1], b[i + 1 == size ? 0 : i + 1] };
+        }
+        for (uint32_t v {}; v < size; ++v) {
+            auto& la = buf.link_[v];
+            auto& lb = buf.link_b_[v];
+            buf.rest_a_[v] = { none, none };
+            buf.rest_b_[v] = { none, none };
+            for (auto u : la) {
+                if (u != lb[0] && u != lb[1]) {
+                    buf.rest_a_[v][buf.rest_a_[v][0] == none ? 0 : 1] = u;
+                }
+            }
+            for (auto u : lb) {
+                if (u != la[0] && u != la[1]) {
+                    buf.rest_b_[v][buf.rest_b_[v][0] == none ? 0 : 1] = u;
+                }
+            }
+            buf.walk_index_[v] = { none, none };
+        }
+
+        buf.cycles_.clear();
+        buf.offsets_.assign(1, 0);
+        for (uint32_t start {}; start < size; ++start) {
+            while (detail::count(buf.rest_a_[start]) != 0) {
+                auto& walk = buf.walk_;
+                walk.assign(1, start);
+                buf.walk_index_[start][0] = 0;
+
+                while (walk.size() > 1 || detail::count(buf.rest_a_[start]) != 0) {
+                    // parzysta pozycja -> teraz krawedz A, nieparzysta -> B
+                    const auto current = walk.back();
+                    const auto parity = (walk.size() - 1) & 1;
+                    auto& rest = parity == 0 ? buf.rest_a_ : buf.rest_b_;
+                    const auto next = detail::pick(rest[current], rng);
+                    detail::take(rest[current], next);
+                    detail::take(rest[next], current);
+
+                    const auto next_parity = walk.size() & 1;
+                    const auto seen = buf.walk_index_[next][next_parity];
+                    if (seen == none) {
+                        buf.walk_index_[next][next_parity] = static_cast<uint32_t>(walk.size());
+                        walk.push_back(next);
+                        continue;
+                    }
+
+                    // cykl walk[seen..] + next -- zapisywany od krawedzi A
+                    const auto first = seen + (seen & 1);
+                    for (auto i = first; i < walk.size(); ++i) {
+                        buf.cycles_.push_back(walk[i]);
+                    }
+                    if (seen & 1) {
+                        buf.cycles_.push_back(walk[seen]);
+                    }
+                    buf.offsets_.push_back(static_cast<uint32_t>(buf.cycles_.size()));
+
+                    for (auto i = seen + 1; i < walk.size(); ++i) {
+                        buf.walk_index_[walk[i]][i & 1] = none;
+                    }
+                    walk.resize(seen + 1);
+                }
+                buf.walk_index_[start][0] = none;
+            }
+        }
+    }
+
+    /**
+     * @brief AB-cykle ATSP: krawedz A v -> succ_a(v), potem wstecz po krawedzi B do pred_b(succ_a(v)),
+     * wiec spacer jest wyznaczony jednoznacznie, a AB-cykle to cykle tej permutacji bez punktow stalych (wspolnych krawedzi)
+     */
+    inline void ab_cycles_directed(std::span<const uint32_t> a, std::span<const uint32_t> b, buffers& buf)
+    {
+        const auto size = a.size();
+        for (std::size_t i {}; i < size; ++i) {
+            buf.link_[a[i]] = { a[i == 0 ? size - 1 : i - 1], a[i + 1 == size ? 0 : i + 1] };
+            buf.link_b_[b[i]] = { b[i == 0 ? size - 1 : i - 1], b[i + 1 == size ? 0 : i + 1] };
+        }
+
+        buf.cycles_.clear();
+        buf.offsets_.assign(1, 0);
+        const auto stamp = buf.next_stamp();
+        for (uint32_t start {}; start < size; ++start) {
+            if (buf.marks_[start] == stamp) {
+                continue;
+            }
+            auto v = start;
+            do {
+                buf.marks_[v] = stamp;
+                const auto to = buf.link_[v][1];
+                const auto back = buf.link_b_[to][0];
+                if (back == v) {
+                    break;
+                }
+                buf.cycles_.push_back(v);
+                buf.cycles_.push_back(to);
+                v = back;
+            } while (v != start);
+
+            if (buf.cycles_.size() != buf.offsets_.back()) {
+                buf.offsets_.push_back(static_cast<uint32_t>(buf.cycles_.size()));
+            }
+        }
+    }
+
+    /**
+     * @brief E-set z jednego AB-cyklu: krawedzie A cyklu usuniete, krawedzie B dodane -- zostaja podtrasy
+     * @return zmiana kosztu
+     */
+    inline auto apply(std::span<const uint32_t> cycle, const context& ctx, buffers& buf) -> delta_type
+    {
+        const auto length = cycle.size();
+        delta_type delta {};
+        if (ctx.symmetric_) {
+            for (std::size_t i {}; i < length; i += 2) {
+                const auto u = cycle[i];
+                const auto v = cycle[i + 1];
+                detail::replace(buf.touch(u), v, none);
+                detail::replace(buf.touch(v), u, none);
+                delta -= ctx.cost(u, v);
+            }
+            for (std::size_t i = 1; i < length; i += 2) {
+                const auto u = cycle[i];
+                const auto v = cycle[i + 1 == length ? 0 : i + 1];
+                detail::replace(buf.touch(u), none, v);
+                detail::replace(buf.touch(v), none, u);
+                delta += ctx.cost(u, v);
+            }
+            return delta;
+        }
+
+        // pary (v, succ_a(v)), a krawedz B wchodzi do succ_a(v) z nastepnego v w cyklu
+        for (std::size_t i {}; i < length; i += 2) {
+            const auto to = cycle[i + 1];
+            const auto from = cycle[i + 2 == length ? 0 : i + 2];
+            delta += ctx.cost(from, to) - ctx.cost(cycle[i], to);
+            buf.touch(from)[1] = to;
+            buf.touch(to)[0] = from;
+        }
+        return delta;
+    }
+
+    inline auto step(std::array<uint32_t, 2> const& link, uint32_t previous, bool symmetric) -> uint32_t
+    {
+        if (!symmetric) {
+            return link[1];
+        }
+        return link[0] == previous ? link[1] : link[0];
+    }
+
+    /**
+     * @brief numeruje podtrasy i zwraca ich liczbe
+     */
+    inline auto label(std::size_t size, buffers& buf, bool symmetric) -> uint32_t
+    {
+        const auto stamp = buf.next_stamp();
+        buf.sizes_.clear();
+        for (uint32_t start {}; start < size; ++start) {
+            if (buf.marks_[start] == stamp) {
+                continue;
+            }
+            const auto id = static_cast<uint32_t>(buf.sizes_.size());
+            uint32_t count {};
+            auto previous = buf.link_[start][0];
+            auto v = start;
+            do {
+                buf.marks_[v] = stamp;
+                buf.subtour_[v] = id;
+                ++count;
+                const auto next = step(buf.link_[v], previous, symmetric);
+                previous = v;
+                v = next;
+            } while (v != start);
+            buf.sizes_.push_back(count);
+        }
+        return static_cast<uint32_t>(buf.sizes_.size());
+    }
+
+    /**
+     * @brief najmniejsza podtrasa jest doklejana do innej: usuwane krawedzie (u, u') i (v, v'), dodawane (u, v) i (u', v')
+     * (dla ATSP u -> w i pred(w) -> succ(u)) -- v szukane na listach kandydatow u, a jak wszyscy sa w tej samej podtrasie, wsrod wszystkich
+     */
+    inline auto merge(const context& ctx, buffers& buf, uint32_t subtours) -> delta_type
+    {
+        const auto size = buf.link_.size();
+        const bool symmetric = ctx.symmetric_;
+        delta_type delta {};
+
+        while (subtours > 1) {
+            uint32_t smallest {};
+            for (uint32_t id {}; id < buf.sizes_.size(); ++id) {
+                if (buf.sizes_[id] != 0 && (buf.sizes_[smallest] == 0 || buf.sizes_[id] < buf.sizes_[smallest])) {
+                    smallest = id;
+                }
+            }
+
+            auto& members = buf.members_;
+            members.clear();
+            {
+                const auto start = static_cast<uint32_t>(std::find(buf.subtour_.begin(), buf.subtour_.end(), smallest) - buf.subtour_.begin());
+                auto previous = buf.link_[start][0];
+                auto v = start;
+                do {
+                    members.push_back(v);
+                    const auto next = step(buf.link_[v], previous, symmetric);
+                    previous = v;
+                    v = next;
+                } while (v != start);
+            }
+
+            auto best = std::numeric_limits<delta_type>::max();
+            std::array<uint32_t, 4> move { none, none, none, none };
+            auto consider = [&](uint32_t u, uint32_t v) {
+                if (symmetric) {
+                    for (auto u1 : buf.link_[u]) {
+                        for (auto v1 : buf.link_[v]) {
+                            const auto gain = ctx.cost(u, v) + ctx.cost(u1, v1) - ctx.cost(u, u1) - ctx.cost(v, v1);
+                            if (gain < best) {
+                                best = gain;
+                                move = { u, u1, v, v1 };
+                            }
+                        }
+                    }
+                    return;
+                }
+                // u -> v i pred(v) -> succ(u)
+                const auto u1 = buf.link_[u][1];
+                const auto v0 = buf.link_[v][0];
+                const auto gain = ctx.cost(u, v) + ctx.cost(v0, u1) - ctx.cost(u, u1) - ctx.cost(v0, v);
+                if (gain < best) {
+                    best = gain;
+                    move = { u, u1, v0, v };
+                }
+            };
+
+            for (auto u : members) {
+                for (auto v : ctx.neighbours_.at(u)) {
+                    if (buf.subtour_[v] != smallest) {
+                        consider(u, v);
+                    }
+                }
+            }
+            if (move[0] == none) {
+                for (auto u : members) {
+                    for (uint32_t v {}; v < size; ++v) {
+                        if (buf.subtour_[v] != smallest) {
+                            consider(u, v);
+                        }
+                    }
+                }
+            }
+
+            const auto [u, u1, v, v1] = move;
+            if (symmetric) {
+                detail::replace(buf.touch(u), u1, v);
+                detail::replace(buf.touch(u1), u, v1);
+                detail::replace(buf.touch(v), v1, u);
+                detail::replace(buf.touch(v1), v, u1);
+            } else {
+                // move = { u, succ(u), pred(w), w }
+                buf.touch(u)[1] = v1;
+                buf.touch(v1)[0] = u;
+                buf.touch(v)[1] = u1;
+                buf.touch(u1)[0] = v;
+            }
+            delta += best;
+
+            const auto target = buf.subtour_[symmetric ? v : v1];
+            for (auto m : members) {
+                buf.subtour_[m] = target;
+            }
+            buf.sizes_[target] += buf.sizes_[smallest];
+            buf.sizes_[smallest] = 0;
+            --subtours;
+        }
+
+        return delta;
+    }
+}
+
+/**
+ * @brief edge assembly crossover (EAX-rand, E-set z jednego AB-cyklu): AB-cykle z sumy krawedzi rodzicow, kazdy z losowo
+ * wybranych (najwyzej max_tries) jest probnie stosowany do a, a powstale podtrasy sa zachlannie sklejane ruchem w stylu 2-opt
+ * proby sa wycofywane z logu zmian, a dziecko powstaje z najlepszej -- dziedziczy prawie wszystkie krawedzie po rodzicach
+ * @return koszt dziecka - koszt a. identyczni rodzice -> kopia a
+ */
+inline auto crossover(std::span<const uint32_t> a, std::span<const uint32_t> b, std::span<uint32_t> child, const context& ctx, buffers& buf, auto& rng)
+    -> delta_type
+{
+    const auto size = a.size();
+    if (size < 5) {
+        std::copy(a.begin(), a.end(), child.begin());
+        return 0;
+    }
+    buf.resize(size);
+
+    if (ctx.symmetric_) {
+        detail::ab_cycles_undirected(a, b, buf, rng);
+    } else {
+        detail::ab_cycles_directed(a, b, buf);
+    }
+
+    const auto cycles = buf.offsets_.size() - 1;
+    if (cycles == 0) {
+        std::copy(a.begin(), a.end(), child.begin());
+        return 0;
+    }
+
+    // link_ to teraz trasa a -- proby modyfikuja je w miejscu
+    auto try_cycle = [&](std::size_t index) {
+        const std::span<const uint32_t> cycle { buf.cycles_.data() + buf.offsets_[index], buf.cycles_.data() + buf.offsets_[index + 1] };
+        const auto delta = detail::apply(cycle, ctx, buf);
+        return delta + detail::merge(ctx, buf, detail::label(size, buf, ctx.symmetric_));
+    };
+
+    const auto first = std::uniform_int_distribution<std::size_t>(0, cycles - 1)(rng);
+    const auto tries = std::min(cycles, max_tries);
+    auto best = std::numeric_limits<delta_type>::max();
+    std::size_t chosen {};
+    buf.log_.clear();
+    for (std::size_t t {}; t < tries; ++t) {
+        const auto index = (first + t) % cycles;
+        const auto delta = try_cycle(index);
+        if (delta < best) {
+            best = delta;
+            chosen = index;
+        }
+        buf.undo();
+    }
+    try_cycle(chosen);
+    buf.log_.clear();
+
+    auto previous = buf.link_[a[0]][0];
+    auto v = a[0];
+    for (std::size_t i {}; i < size; ++i) {
+        child[i] = v;
+        const auto next = detail::step(buf.link_[v], previous, ctx.symmetric_);
+        previous = v;
+        v = next;
+    }
+
+    return best;
+}
+
+}
@@ -2,87 +2,466 @@
 
 #include "config.hpp"
 #include "path.hpp"
+#include "solver/balas_simonetti.hpp"
+#include "solver/eax.hpp"
+#include "solver/local_search.hpp"
+#include "solver/lower_bound.hpp"
 #include "solver/prdprinter.hpp"
-#include "solver/sort_permutation.hpp"
-#include "solver/surroundings.hpp"
 
+#include "utils/alias_table.hpp"
+#include "utils/bounded_queue.hpp"
 #include "utils/thread_pool.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <future>
+#include <initializer_list>
+#include <iostream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <optional>
 #include <random>
-#include <set>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace tsp::solver::genetic {
 
-namespace selection_operator {
+using city_type = uint32_t;
+// chromosom to otwarta trasa (bez powtorzonego miasta na koncu) -- wiersz w bloku populacji
+using chromosome = std::span<city_type>;
+using const_chromosome = std::span<const city_type>;
+using delta_type = int64_t;
 
-    template <typename Rng>
-    struct roulette_wheel_selection {
-        static auto select(
-            std::vector<config::path_type> const& population,
-            std::vector<config::value_type> const& fitness_values,
-            std::size_t choose_n,
-            Rng& rng)
-            -> std::vector<config::path_type const*>
+using tsp::calculate_value;
+
+/**
+ * @brief wartosc otwartej trasy razem z krawedzia powrotna
+ */
+inline auto calculate_value(const ds::heap_matrix<config::value_type>& matrix, const_chromosome genes) -> config::value_type
+{
+    config::value_type total_value {};
+    for (std::size_t i = 1; i < genes.size(); ++i) {
+        total_value += matrix.at(genes[i - 1], genes[i]);
+    }
+
+    return total_value + matrix.at(genes.back(), genes.front());
+}
+
+/**
+ * @brief skrot krawedzi (splitmix64) -- dla STSP krawedz bez kierunku
+ */
+inline auto edge_hash(city_type from, city_type to, bool symmetric) -> uint64_t
+{
+    if (symmetric && to < from) {
+        std::swap(from, to);
+    }
+    uint64_t x = (static_cast<uint64_t>(from) << 32 | to) + 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief skrot zbioru krawedzi trasy -- suma nie zalezy od miasta startowego, a dla STSP tez od kierunku
+ */
+inline auto tour_hash(const_chromosome genes, bool symmetric) -> uint64_t
+{
+    uint64_t hash {};
+    for (std::size_t i {}; i < genes.size(); ++i) {
+        hash += edge_hash(genes[i], genes[i + 1 == genes.size() ? 0 : i + 1], symmetric);
+    }
+    return hash;
+}
+
+/**
+ * @brief zbior skrotow tras jednego pokolenia wstawianych rownolegle przez watki rozmnazajace -- otwarte adresowanie na atomikach
+ * kazde dziecko wstawia najwyzej 2 skroty (przed i po enchance), wiec 4 * capacity slotow nigdy sie nie zapelni
+ */
+class hash_set {
+    std::vector<std::atomic<uint64_t>> slots_;
+    std::size_t mask_;
+
+public:
+    explicit hash_set(std::size_t capacity)
+        : slots_(std::bit_ceil(std::max<std::size_t>(4 * capacity, 2)))
+        , mask_ { slots_.size() - 1 }
+    {
+    }
+
+    void clear()
+    {
+        for (auto& slot : slots_) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @return false jezeli skrot juz byl w zbiorze
+     */
+    auto insert(uint64_t hash) -> bool
+    {
+        // 0 oznacza pusty slot
+        hash = hash == 0 ? 1 : hash;
+        for (auto index = hash & mask_;; index = (index + 1) & mask_) {
+            uint64_t expected = 0;
+            if (slots_[index].compare_exchange_strong(expected, hash, std::memory_order_relaxed)) {
+                return true;
+            }
+            if (expected == hash) {
+                return false;
+            }
+        }
+    }
+};
+
+/**
+ * @brief populacja w jednym ciaglym bloku size * cities miast, wiersz kazdego osobnika zaczyna sie na granicy linii cache
+ * fitness, ranga i rodzice w rownoleglych tablicach indeksowanych numerem osobnika -- solver trzyma dwie populacje
+ * i zamienia je miejscami co pokolenie, wiec po starcie nic nie jest allokowane
+ *
+ * dla ATSP kazdy osobnik ma tez sumy prefiksowe P[k] = suma po t < k z d(c_t+1, c_t) - d(c_t, c_t+1) -- odwrocenie
+ * [i, j) zmienia koszt krawedzi wewnatrz o P[j-1] - P[i]. sa liczone przy pelnej ocenie albo leniwie, przy pierwszej
+ * mutacji kopii osobnika, a potem dziela je wszystkie dzieci tego rodzica
+ */
+class population {
+    static constexpr std::size_t alignment = 64;
+
+    enum prefix_state : uint8_t {
+        prefix_empty,
+        prefix_building,
+        prefix_ready,
+    };
+
+    struct aligned_delete {
+        void operator()(city_type* genes) const
         {
-            std::vector<config::path_type const*> choosen_solutions {};
-            choosen_solutions.resize(choose_n);
+            ::operator delete[](genes, std::align_val_t { alignment });
+        }
+    };
+
+    std::size_t size_ {};
+    std::size_t cities_ {};
+    std::size_t stride_ {};
+    std::unique_ptr<city_type[], aligned_delete> genes_ {};
+
+    std::unique_ptr<delta_type[]> reversal_prefix_ {}; // size * cities, tylko dla ATSP
+    std::unique_ptr<std::atomic<uint8_t>[]> prefix_state_ {};
+
+    /**
+     * @return wartosc trasy
+     */
+    auto fill_prefix(std::size_t index, const ds::heap_matrix<config::value_type>& matrix) -> config::value_type
+    {
+        const auto genes = at(index);
+        auto* prefix = reversal_prefix_.get() + index * cities_;
+
+        config::value_type total_value {};
+        delta_type reversed {};
+        prefix[0] = 0;
+        for (std::size_t i = 1; i < cities_; ++i) {
+            const auto forward = matrix.at(genes[i - 1], genes[i]);
+            total_value += forward;
+            reversed += static_cast<delta_type>(matrix.at(genes[i], genes[i - 1])) - static_cast<delta_type>(forward);
+            prefix[i] = reversed;
+        }
+
+        return total_value + matrix.at(genes.back(), genes.front());
+    }
+
+public:
+    std::vector<config::value_type> fitness_ {};
+    std::vector<uint32_t> rank_ {}; // 0 -- najlepszy, posortowane sa tylko elity, reszta ma rangi w dowolnej kolejnosci
+    std::vector<std::array<uint32_t, 2>> parents_ {}; // indeksy rodzicow w poprzednim pokoleniu
+    std::vector<uint64_t> hash_ {}; // tour_hash, aktualizowany przez rehash()
+
+    population(std::size_t size, std::size_t cities, bool symmetric)
+        : size_ { size }
+        , cities_ { cities }
+        , stride_ { (cities + alignment / sizeof(city_type) - 1) / (alignment / sizeof(city_type)) * (alignment / sizeof(city_type)) }
+        , genes_ { static_cast<city_type*>(::operator new[](size * stride_ * sizeof(city_type), std::align_val_t { alignment })) }
+        , fitness_(size)
+        , rank_(size)
+        , parents_(size)
+        , hash_(size)
+    {
+        if (!symmetric) {
+            reversal_prefix_ = std::make_unique<delta_type[]>(size * cities);
+            prefix_state_ = std::make_unique<std::atomic<uint8_t>[]>(size);
+        }
+    }
+
+    auto size() const -> std::size_t
+    {
+        return size_;
+    }
+
+    auto cities() const -> std::size_t
+    {
+        return cities_;
+    }
+
+    auto at(std::size_t index) -> chromosome
+    {
+        return { genes_.get() + index * stride_, cities_ };
+    }
+
+    auto at(std::size_t index) const -> const_chromosome
+    {
+        return { genes_.get() + index * stride_, cities_ };
+    }
+
+    /**
+     * @brief pelna ocena osobnika -- dla ATSP przy okazji sumy prefiksowe
+     */
+    void evaluate(std::size_t index, const ds::heap_matrix<config::value_type>& matrix)
+    {
+        if (!reversal_prefix_) {
+            fitness_[index] = calculate_value(matrix, at(index));
+            return;
+        }
+
+        fitness_[index] = fill_prefix(index, matrix);
+        prefix_state_[index].store(prefix_ready, std::memory_order_release);
+    }
+
+    void rehash(std::size_t index)
+    {
+        hash_[index] = tour_hash(at(index), !reversal_prefix_);
+    }
+
+    /**
+     * @brief osobnik zostal zmieniony bez pelnej oceny
+     */
+    void invalidate(std::size_t index)
+    {
+        if (prefix_state_) {
+            prefix_state_[index].store(prefix_empty, std::memory_order_relaxed);
+        }
+    }
 
-            std::size_t size = population.size();
-            config::value_type sum {};
-            for (std::size_t i {}; i < size; ++i) {
-                sum += fitness_values[i];
+    /**
+     * @brief sumy prefiksowe osobnika, liczone przy pierwszym uzyciu -- moze byc wolane z wielu watkow naraz
+     */
+    auto reversal_prefix(std::size_t index, const ds::heap_matrix<config::value_type>& matrix) -> const delta_type*
+    {
+        auto& state = prefix_state_[index];
+        if (state.load(std::memory_order_acquire) != prefix_ready) {
+            uint8_t expected = prefix_empty;
+            if (state.compare_exchange_strong(expected, prefix_building, std::memory_order_acq_rel)) {
+                fill_prefix(index, matrix);
+                state.store(prefix_ready, std::memory_order_release);
+            } else {
+                while (state.load(std::memory_order_acquire) != prefix_ready) {
+                    std::this_thread::yield();
+                }
             }
+        }
 
-            std::vector<double> probs {};
-            probs.resize(size);
-            double probs_sum {};
-            for (std::size_t i {}; i < size; ++i) {
-                double prob = probs_sum + double(fitness_values[i]) / sum;
-                probs[i] = prob;
-                probs_sum += prob;
+        return reversal_prefix_.get() + index * cities_;
+    }
+
+    /**
+     * @brief kopia osobnika z innej populacji razem z fitnessem i gotowymi sumami prefiksowymi
+     */
+    void assign(std::size_t index, const population& other, std::size_t other_index)
+    {
+        const auto genes = other.at(other_index);
+        std::copy(genes.begin(), genes.end(), at(index).begin());
+        fitness_[index] = other.fitness_[other_index];
+        hash_[index] = other.hash_[other_index];
+
+        if (prefix_state_) {
+            const bool ready = other.prefix_state_[other_index].load(std::memory_order_acquire) == prefix_ready;
+            if (ready) {
+                const auto* prefix = other.reversal_prefix_.get() + other_index * cities_;
+                std::copy(prefix, prefix + cities_, reversal_prefix_.get() + index * cities_);
             }
+            prefix_state_[index].store(ready ? prefix_ready : prefix_empty, std::memory_order_relaxed);
+        }
+    }
 
-            // wazone losowanie ze zwracaniem ?? czy moze lepiej nie zwracac
-            std::uniform_real_distribution<> distr {};
-            for (std::size_t n {}; n < choose_n; ++n) {
-                double random = distr(rng);
+    /**
+     * @brief osobnik ze znanym fitnessem spoza populacji (np migrant z innej wyspy)
+     */
+    void assign(std::size_t index, const_chromosome genes, config::value_type fitness)
+    {
+        std::copy(genes.begin(), genes.end(), at(index).begin());
+        fitness_[index] = fitness;
+        rehash(index);
+        invalidate(index);
+    }
+};
+
+/**
+ * @brief bufory jednego watku rozmnazajacego -- tworzone raz na cale wywolanie solvera
+ */
+template <typename Rng>
+struct workspace {
+    Rng rng_;
+
+    // krzyzowania: znacznik jest ustawiony, jezeli marks_[x] == stamp_ -- nowy stamp czysci wszystkie naraz w O(1)
+    std::vector<uint32_t> marks_ {};
+    uint32_t stamp_ {};
+    std::vector<uint32_t> position_ {}; // pozycja miasta w rodzicu
+    std::vector<std::array<uint32_t, 4>> adjacency_ {}; // edge recombination: sasiedzi z obu rodzicow
+    std::vector<uint8_t> degree_ {};
+
+    // edge assembly: kontekst ustawia solver, jezeli wybrano to krzyzowanie
+    const eax::context* eax_context_ {};
+    eax::buffers eax_ {};
+
+    // enchance: balas_simonetti dziala na zamknietych trasach, local search na wlasnej trasie z optimizerem
+    config::path_type path_ {};
+    std::optional<local_search::tour> tour_ {};
+    std::optional<local_search::optimizer<local_search::matrix_cost>> optimizer_ {};
+
+    workspace(std::size_t cities, Rng const& rng)
+        : rng_ { rng }
+        , marks_(cities, 0)
+        , position_(cities)
+        , adjacency_(cities)
+        , degree_(cities)
+    {
+        path_.reserve(cities + 1);
+    }
+
+    auto next_stamp() -> uint32_t
+    {
+        if (++stamp_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            stamp_ = 1;
+        }
+        return stamp_;
+    }
+};
+
+/**
+ * @brief bufory selekcji jednego pokolenia -- tworzone raz na cale wywolanie solvera
+ */
+struct selection_scratch {
+    std::vector<double> weights_ {};
+    std::vector<uint32_t> order_ {}; // do wag z rang
+    utils::alias_table table_ {};
+
+    explicit selection_scratch(std::size_t size)
+        : weights_(size)
+        , order_(size)
+    {
+    }
+};
+
+// nacisk selekcji liniowego rankingu: najlepszy ma wage pressure, najgorszy 2 - pressure
+constexpr double rank_pressure = 1.7;
+
+namespace selection_operator {
+
+    /**
+     * @brief wagi do losowania rodzicow, wieksza -- lepszy osobnik
+     * z fitnessu: f_max - f + 1 (minimalizacja, rowne osobniki -> rowne szanse)
+     * z rang: liniowy ranking, nie zalezy od skali kosztow
+     */
+    inline void weights(population const& population, selection_scratch& scratch, bool rank)
+    {
+        const auto size = population.size();
+        auto& weights = scratch.weights_;
+        weights.resize(size);
+
+        if (rank) {
+            auto& order = scratch.order_;
+            order.resize(size);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&population](uint32_t l, uint32_t r) {
+                return population.fitness_[l] < population.fitness_[r];
+            });
+
+            const auto last = static_cast<double>(std::max<std::size_t>(1, size - 1));
+            for (std::size_t r {}; r < size; ++r) {
+                weights[order[r]] = 2. - rank_pressure + 2. * (rank_pressure - 1.) * static_cast<double>(size - 1 - r) / last;
+            }
+            return;
+        }
+
+        const auto worst = *std::max_element(population.fitness_.begin(), population.fitness_.end());
+        for (std::size_t i {}; i < size; ++i) {
+            weights[i] = static_cast<double>(worst - population.fitness_[i]) + 1.;
+        }
+    }
+
+    /**
+     * @brief ruletka metoda aliasow: tablica budowana raz na pokolenie w O(P), kazde losowanie O(1)
+     * rodzicow losuja z scratch.table_ bezposrednio watki rozmnazajace -- patrz solver::select
+     */
+    struct roulette_wheel_selection {
+        static void prepare(population const& population, selection_scratch& scratch, bool rank)
+        {
+            weights(population, scratch, rank);
+            scratch.table_.build(scratch.weights_);
+        }
+    };
 
-                auto iter = std::lower_bound(probs.begin(), probs.end(), random);
-                // musi znalezc bo zawiera wszystkie przedzialy z [0;1]
-                assert(iter != probs.end());
+    /**
+     * @brief stochastic universal sampling: jedna losowa liczba i N rownych krokow po skumulowanych wagach, O(P + N)
+     * kazdy osobnik jest wybrany floor albo ceil oczekiwanej liczby razy -- bez wariancji zwyklej ruletki
+     */
+    template <typename Rng>
+    struct stochastic_universal_sampling {
+        static void select(
+            population const& population,
+            std::span<uint32_t> choosen_solutions,
+            selection_scratch& scratch,
+            bool rank,
+            Rng& rng)
+        {
+            weights(population, scratch, rank);
+            const auto& weights = scratch.weights_;
 
-                std::size_t elem_at = std::distance(probs.begin(), iter);
-                choosen_solutions[n] = &population[elem_at];
+            double sum {};
+            for (auto w : weights) {
+                sum += w;
             }
 
-            return choosen_solutions;
+            const auto count = choosen_solutions.size();
+            const auto step = sum / static_cast<double>(count);
+            auto pointer = std::uniform_real_distribution<>(0., step)(rng);
+
+            std::size_t index {};
+            double cumulative = weights[0];
+            for (std::size_t n {}; n < count; ++n, pointer += step) {
+                while (cumulative <= pointer && index + 1 < weights.size()) {
+                    cumulative += weights[++index];
+                }
+                choosen_solutions[n] = static_cast<uint32_t>(index);
+            }
         }
     };
 
     template <typename Rng, std::size_t TourneySize>
     struct tourney_selection {
-        static auto select(
-            std::vector<config::path_type> const& population,
-            std::vector<config::value_type> const& fitness_values,
-            std::size_t choose_n,
+        static void select(
+            population const& population,
+            std::span<uint32_t> selected_solutions,
+            [[maybe_unused]] selection_scratch& scratch,
+            [[maybe_unused]] bool rank,
             Rng& rng)
-            -> std::vector<config::path_type const*>
         {
-            std::vector<config::path_type const*> selected_solutions(choose_n);
-
             auto size = population.size();
             std::uniform_int_distribution<std::size_t> distr(0, size - 1);
-            for (decltype(choose_n) nth {}; nth < choose_n; ++nth) {
+            for (std::size_t nth {}; nth < selected_solutions.size(); ++nth) {
                 std::array<std::size_t, TourneySize> inds {};
                 for (std::size_t i {}; i < inds.size(); ++i) {
                     inds[i] = distr(rng);
@@ -90,46 +469,46 @@ namespace selection_operator {
 
                 std::size_t best = inds[0];
                 for (std::size_t i = 1; i < inds.size(); ++i) {
-                    if (fitness_values[best] < fitness_values[inds[i]]) {
+                    if (population.fitness_[inds[i]] < population.fitness_[best]) {
                         best = inds[i];
                     }
                 }
 
-                selected_solutions[nth] = &population[best];
+                selected_solutions[nth] = static_cast<uint32_t>(best);
             }
-
-            return selected_solutions;
         }
     };
 }
 
 template <typename MutationOperator>
-inline auto create_initial_population(
-    config::path_type const& solution,
-    std::size_t population_size,
+inline void create_initial_population(
+    const_chromosome solution,
+    population& population,
     auto& rng)
-    -> std::vector<config::path_type>
 {
-    std::vector<config::path_type> population {};
-    population.resize(population_size);
-
-    for (std::size_t i {}; i < population_size; ++i) {
-        population[i] = solution;
-        MutationOperator::mutate(population[i], rng);
+    for (std::size_t i {}; i < population.size(); ++i) {
+        auto genes = population.at(i);
+        std::copy(solution.begin(), solution.end(), genes.begin());
+        MutationOperator::mutate(genes, rng);
     }
-
-    return population;
 }
 
 namespace crossover_operator {
 
-    // struct partially_mapped {
-    //     static auto crossover(const config::path_type& a, const config::path_type& b, auto& rng)
-    //         -> const config::path_type
-    //     {
-    //         // zlozony obliczeniowo.. nie wiem czy chcemy...
-    //     }
-    // };
+    /**
+     * @brief losowy przedzial [from, to) do skopiowania z pierwszego rodzica
+     */
+    inline auto cut_points(std::size_t size, auto& rng) -> std::pair<std::size_t, std::size_t>
+    {
+        std::uniform_int_distribution<std::size_t> distr(0, size - 1);
+
+        // WTF segfault na release GCC jak nie sa jako zmienne??? to jest zdecydowanie poprawne jezykowo
+        // na clangu dziala normalnie na releasie
+        // auto [ind_a, ind_b] = std::minmax(distr(rng), distr(rng));
+        auto po = distr(rng);
+        auto poo = distr(rng);
+        return std::minmax(po, poo);
+    }
 
     /**
      * @brief kopiuje srodek przedzzialu, a potem zachowujac kolejnosc b wypelnia niepowtarzajacymi sie
@@ -137,42 +516,25 @@ namespace crossover_operator {
      */
     template <typename Rng>
     struct order {
-        static auto crossover(const config::path_type& a, const config::path_type& b, Rng& rng)
-            -> config::path_type
+        static void crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws)
         {
-            config::path_type child {};
-
-            // cut pointsy
-            std::size_t size = a.size() - 1; // bo powtorka poczatku
+            std::size_t size = a.size();
             assert(a.size() == b.size());
             assert(size >= 2);
 
-            child.resize(size + 1);
-            std::uniform_int_distribution<std::size_t> distr(0, size - 1);
-
-            // WTF segfault na release GCC jak nie sa jako zmienne??? to jest zdecydowanie poprawne jezykowo
-            // na clangu dziala normalnie na releasie
-            // auto [ind_a, ind_b] = std::minmax(distr(rng), distr(rng));
-            auto po = distr(rng);
-            auto poo = distr(rng);
-            auto [ind_a, ind_b] = std::minmax(po, poo);
-
-            // assert(ind_a < size);
-            // assert(ind_b < size);
-
-            std::set<config::path_type::value_type> skip {};
-            for (auto ind = ind_a; ind < ind_b; ++ind) {
-                skip.insert(a[ind]);
-            }
+            auto [ind_a, ind_b] = cut_points(size, ws.rng_);
 
+            const auto stamp = ws.next_stamp();
             for (auto ind = ind_a; ind < ind_b; ++ind) {
+                ws.marks_[a[ind]] = stamp;
                 child[ind] = a[ind];
             }
 
             auto child_ptr = ind_b;
-            for (std::size_t ind = ind_b; ind < size; ++ind) {
-                config::path_type::value_type city = b[ind];
-                if (!skip.contains(city)) {
+            for (std::size_t step {}; step < size; ++step) {
+                auto ind = ind_b + step;
+                auto city = b[ind < size ? ind : ind - size];
+                if (ws.marks_[city] != stamp) {
                     child[child_ptr] = city;
                     ++child_ptr;
                     if (child_ptr == size) {
@@ -180,46 +542,203 @@ namespace crossover_operator {
                     }
                 }
             }
-            for (std::size_t ind = 0; ind < ind_b; ++ind) {
-                config::path_type::value_type city = b[ind];
-                if (!skip.contains(city)) {
-                    child[child_ptr] = city;
-                    ++child_ptr;
-                    if (child_ptr == size) {
-                        child_ptr = 0;
+        }
+    };
+
+    /**
+     * @brief PMX: srodek z a, reszta z b na tych samych pozycjach -- miasto z b, ktore jest juz w srodku,
+     * jest zamieniane przez odwzorowanie a[i] -> b[i] az trafi na miasto spoza srodka
+     */
+    template <typename Rng>
+    struct partially_mapped {
+        static void crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws)
+        {
+            std::size_t size = a.size();
+            assert(a.size() == b.size());
+            assert(size >= 2);
+
+            auto [ind_a, ind_b] = cut_points(size, ws.rng_);
+
+            const auto stamp = ws.next_stamp();
+            for (auto ind = ind_a; ind < ind_b; ++ind) {
+                ws.marks_[a[ind]] = stamp;
+                ws.position_[a[ind]] = static_cast<uint32_t>(ind);
+                child[ind] = a[ind];
+            }
+
+            for (std::size_t ind {}; ind < size; ++ind) {
+                if (ind == ind_a) {
+                    ind = ind_b;
+                    if (ind == size) {
+                        break;
                     }
                 }
+
+                auto city = b[ind];
+                while (ws.marks_[city] == stamp) {
+                    city = b[ws.position_[city]];
+                }
+                child[ind] = city;
+            }
+        }
+    };
+
+    /**
+     * @brief CX: pozycje dziela sie na cykle a[i] -> pozycja tego miasta w b, kolejne cykle na zmiane z a i z b
+     * kazde miasto zostaje na pozycji, ktora mialo w jednym z rodzicow
+     */
+    template <typename Rng>
+    struct cycle {
+        static void crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws)
+        {
+            std::size_t size = a.size();
+            assert(a.size() == b.size());
+
+            for (std::size_t ind {}; ind < size; ++ind) {
+                ws.position_[a[ind]] = static_cast<uint32_t>(ind);
+            }
+
+            // tu znaczniki sa na pozycjach, nie miastach -- obu jest tyle samo
+            const auto stamp = ws.next_stamp();
+            bool from_a = true;
+            for (std::size_t start {}; start < size; ++start) {
+                if (ws.marks_[start] == stamp) {
+                    continue;
+                }
+
+                auto ind = start;
+                do {
+                    ws.marks_[ind] = stamp;
+                    child[ind] = from_a ? a[ind] : b[ind];
+                    ind = ws.position_[b[ind]];
+                } while (ind != start);
+                from_a = !from_a;
+            }
+        }
+    };
+
+    /**
+     * @brief ERX: sasiedzi kazdego miasta z obu rodzicow (najwyzej 4), kolejne miasto to nieodwiedzony sasiad
+     * z najmniejsza liczba pozostalych sasiadow, a jak ich brak -- pierwsze nieodwiedzone w kolejnosci a
+     */
+    template <typename Rng>
+    struct edge_recombination {
+        static void add(workspace<Rng>& ws, city_type from, city_type to)
+        {
+            auto& list = ws.adjacency_[from];
+            auto& degree = ws.degree_[from];
+            if (std::find(list.begin(), list.begin() + degree, to) == list.begin() + degree) {
+                list[degree++] = to;
+            }
+        }
+
+        static void crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws)
+        {
+            std::size_t size = a.size();
+            assert(a.size() == b.size());
+            assert(size >= 2);
+
+            std::fill(ws.degree_.begin(), ws.degree_.end(), 0);
+            for (auto parent : { a, b }) {
+                for (std::size_t ind {}; ind < size; ++ind) {
+                    const auto city = parent[ind];
+                    add(ws, city, parent[ind == 0 ? size - 1 : ind - 1]);
+                    add(ws, city, parent[ind + 1 == size ? 0 : ind + 1]);
+                }
             }
 
-            child.back() = child.front(); // napraw koncowke
+            const auto stamp = ws.next_stamp();
+            std::size_t unvisited {};
+            auto city = a[0];
+            for (std::size_t ind {}; ind < size; ++ind) {
+                child[ind] = city;
+                ws.marks_[city] = stamp;
+
+                // miasto znika z list swoich sasiadow -- ich listy to kandydaci na nastepny krok
+                const auto& list = ws.adjacency_[city];
+                for (uint8_t i {}; i < ws.degree_[city]; ++i) {
+                    auto& other = ws.adjacency_[list[i]];
+                    auto& degree = ws.degree_[list[i]];
+                    auto it = std::find(other.begin(), other.begin() + degree, city);
+                    if (it != other.begin() + degree) {
+                        *it = other[--degree];
+                    }
+                }
+
+                if (ind + 1 == size) {
+                    break;
+                }
+
+                std::optional<city_type> next {};
+                unsigned ties {};
+                for (uint8_t i {}; i < ws.degree_[city]; ++i) {
+                    const auto candidate = list[i];
+                    if (!next || ws.degree_[candidate] < ws.degree_[*next]) {
+                        next = candidate;
+                        ties = 1;
+                    } else if (ws.degree_[candidate] == ws.degree_[*next]) {
+                        // rownomierny wybor wsrod remisow
+                        ++ties;
+                        if (std::uniform_int_distribution<unsigned>(0, ties - 1)(ws.rng_) == 0) {
+                            next = candidate;
+                        }
+                    }
+                }
 
-            // assert_path(child);
-            return child;
+                if (!next) {
+                    while (ws.marks_[a[unvisited]] == stamp) {
+                        ++unvisited;
+                    }
+                    next = a[unvisited];
+                }
+                city = *next;
+            }
+        }
+    };
+
+    /**
+     * @brief EAX -- patrz eax::crossover, potrzebuje eax_context_ w workspace
+     */
+    template <typename Rng>
+    struct edge_assembly {
+        /**
+         * @return zmiana kosztu dziecka wzgledem a
+         */
+        static auto crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws) -> delta_type
+        {
+            assert(ws.eax_context_);
+            return eax::crossover(a, b, child, *ws.eax_context_, ws.eax_, ws.rng_);
         }
     };
 
     template <typename Rng>
     struct random_crossover {
-        static constexpr std::array<double, 1>
+        static constexpr std::array<double, 4>
             probs_ = {
+                0.4,
+                0.6,
+                0.7,
                 1.0
             };
 
-        static constexpr std::array<config::path_type (*)(const config::path_type& a, const config::path_type& b, Rng& rng), 1>
+        static constexpr std::array<void (*)(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws), 4>
             mutations_ = {
-                order<Rng>::crossover
+                order<Rng>::crossover,
+                partially_mapped<Rng>::crossover,
+                cycle<Rng>::crossover,
+                edge_recombination<Rng>::crossover
             };
 
-        static auto crossover(const config::path_type& a, const config::path_type& b, Rng& rng)
+        static void crossover(const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws)
         {
             std::uniform_real_distribution<> distr {};
-            double p = distr(rng);
+            double p = distr(ws.rng_);
 
             auto iter = std::lower_bound(probs_.begin(), probs_.end(), p);
             if (iter != probs_.end()) {
                 std::size_t ind = std::distance(probs_.begin(), iter);
 
-                return mutations_[ind](a, b, rng);
+                return mutations_[ind](a, b, child, ws);
             }
 
             throw std::runtime_error { "crossover wychodzi poza skale" };
@@ -230,24 +749,71 @@ namespace crossover_operator {
 
 namespace mutation_operator {
 
+    /**
+     * @brief do liczenia zmiany kosztu mutacji dziecka, ktore jest jeszcze kopia osobnika parent_ z populacji parents_
+     * mutacje zmieniaja kilka krawedzi na brzegach i ewentualnie kierunek odwracanego fragmentu, wiec wystarczy
+     * policzyc te krawedzie przed i po -- bez kontekstu mutacje nie licza zmiany kosztu i zwracaja 0
+     */
+    struct delta_context {
+        const ds::heap_matrix<config::value_type>& matrix_;
+        bool symmetric_ {};
+        population* parents_ {};
+        uint32_t parent_ {};
+
+        /**
+         * @brief suma krawedzi zaczynajacych sie na podanych pozycjach, kazda liczona raz
+         */
+        auto edges(const_chromosome genes, std::initializer_list<std::size_t> positions) const -> delta_type
+        {
+            const auto size = genes.size();
+
+            delta_type total {};
+            for (auto it = positions.begin(); it != positions.end(); ++it) {
+                if (std::find(positions.begin(), it, *it) == it) {
+                    total += static_cast<delta_type>(matrix_.at(genes[*it], genes[*it + 1 == size ? 0 : *it + 1]));
+                }
+            }
+
+            return total;
+        }
+
+        /**
+         * @brief zmiana kosztu krawedzi wewnatrz odwracanego fragmentu [from, to) -- dla STSP zawsze 0
+         */
+        auto reversal(std::size_t from, std::size_t to) const -> delta_type
+        {
+            if (symmetric_ || to - from < 2) {
+                return 0;
+            }
+
+            const auto* prefix = parents_->reversal_prefix(parent_, matrix_);
+            return prefix[to - 1] - prefix[from];
+        }
+    };
+
     /**
      * @brief mutacja swapujaca 2 losowe miasta miejscami
      *
      */
     struct twor_swap {
-        static void mutate(config::path_type& chromosome, auto& rng)
+        static auto mutate(chromosome chromosome, auto& rng, delta_context const* context = nullptr) -> delta_type
         {
-            std::size_t size = chromosome.size() - 1;
+            std::size_t size = chromosome.size();
             assert(size >= 2);
             std::uniform_int_distribution<std::size_t> distr(0, size - 1);
 
             std::size_t ind_a = distr(rng);
             std::size_t ind_b = distr(rng);
 
-            std::swap(chromosome[ind_a], chromosome[ind_b]);
+            if (!context) {
+                std::swap(chromosome[ind_a], chromosome[ind_b]);
+                return 0;
+            }
 
-            chromosome.back() = chromosome.front(); // napraw koncowke
-            // assert_path(chromosome);
+            auto changed = { (ind_a + size - 1) % size, ind_a, (ind_b + size - 1) % size, ind_b };
+            auto before = context->edges(chromosome, changed);
+            std::swap(chromosome[ind_a], chromosome[ind_b]);
+            return context->edges(chromosome, changed) - before;
         }
     };
 
@@ -256,18 +822,24 @@ namespace mutation_operator {
      *
      */
     struct centre_inverse {
-        static void mutate(config::path_type& chromosome, auto& rng)
+        static auto mutate(chromosome chromosome, auto& rng, delta_context const* context = nullptr) -> delta_type
         {
-            std::size_t size = chromosome.size() - 1;
+            std::size_t size = chromosome.size();
             assert(size >= 2);
             std::uniform_int_distribution<std::size_t> distr(0, size - 1);
 
             std::size_t ind = distr(rng); // poczatek drugiej sekwencji
-            std::reverse(chromosome.begin(), chromosome.begin() + ind);
-            std::reverse(chromosome.begin() + ind, chromosome.begin() + size);
+            if (!context) {
+                std::reverse(chromosome.begin(), chromosome.begin() + ind);
+                std::reverse(chromosome.begin() + ind, chromosome.end());
+                return 0;
+            }
 
-            chromosome.back() = chromosome.front(); // napraw koncowke
-            // assert_path(chromosome);
+            auto changed = { (ind + size - 1) % size, size - 1 };
+            auto before = context->edges(chromosome, changed) - context->reversal(0, ind) - context->reversal(ind, size);
+            std::reverse(chromosome.begin(), chromosome.begin() + ind);
+            std::reverse(chromosome.begin() + ind, chromosome.end());
+            return context->edges(chromosome, changed) - before;
         }
     };
 
@@ -276,17 +848,25 @@ namespace mutation_operator {
      *
      */
     struct reverse_sequence {
-        static void mutate(config::path_type& chromosome, auto& rng)
+        static auto mutate(chromosome chromosome, auto& rng, delta_context const* context = nullptr) -> delta_type
         {
-            std::size_t size = chromosome.size() - 1;
+            std::size_t size = chromosome.size();
             assert(size >= 2);
             std::uniform_int_distribution<std::size_t> distr(0, size);
 
-            auto [ind_a, ind_b] = std::minmax(distr(rng), distr(rng));
-            std::reverse(chromosome.begin() + ind_a, chromosome.begin() + ind_b);
+            // minmax na tymczasowych zwraca wiszace referencje -- najpierw do zmiennych
+            const auto first = distr(rng);
+            const auto second = distr(rng);
+            const auto [ind_a, ind_b] = std::minmax(first, second);
+            if (!context || ind_b - ind_a < 2) {
+                std::reverse(chromosome.begin() + ind_a, chromosome.begin() + ind_b);
+                return 0;
+            }
 
-            chromosome.back() = chromosome.front(); // napraw koncowke
-            // assert_path(chromosome);
+            auto changed = { (ind_a + size - 1) % size, ind_b - 1 };
+            auto before = context->edges(chromosome, changed) - context->reversal(ind_a, ind_b);
+            std::reverse(chromosome.begin() + ind_a, chromosome.begin() + ind_b);
+            return context->edges(chromosome, changed) - before;
         }
     };
 
@@ -299,14 +879,14 @@ namespace mutation_operator {
                 1
             };
 
-        static constexpr std::array<void (*)(config::path_type& chromosome, Rng& rng), 3>
+        static constexpr std::array<delta_type (*)(chromosome chromosome, Rng& rng, delta_context const* context), 3>
             mutations_ = {
                 twor_swap::mutate,
                 centre_inverse::mutate,
                 reverse_sequence::mutate
             };
 
-        static void mutate(config::path_type& chromosome, Rng& rng)
+        static auto mutate(chromosome chromosome, Rng& rng, delta_context const* context = nullptr) -> delta_type
         {
             std::uniform_real_distribution<> distr {};
             double p = distr(rng);
@@ -315,25 +895,86 @@ namespace mutation_operator {
             if (iter != probs_.end()) {
                 std::size_t ind = std::distance(probs_.begin(), iter);
 
-                mutations_[ind](chromosome, rng);
+                return mutations_[ind](chromosome, rng, context);
             }
+
+            return 0;
         }
     };
 }
 
-struct parameters {
-    size_t population_size_ { 100 };
-    uint64_t generations_number_ { 1000 }; // > 0
+enum class selection_type {
+    roulette, // metoda aliasow, rodzice losowani bezposrednio przez watki rozmnazajace
+    sus, // stochastic universal sampling do puli selection_factor_ * P
+    tourney, // turnieje do puli selection_factor_ * P
+};
+
+enum class improvement {
+    two_opt, // 2-opt + Or-opt z don't-look bits (dla ATSP sam Or-opt)
+    or_opt, // sam Or-opt, bez odwracania fragmentow
+    balas_simonetti, // jedno przejscie balas_simonetti z oknem enchance_window_
+};
+
+enum class crossover_type {
+    random, // losowo z tablicy random_crossover
+    eax, // edge assembly -- najlepiej z crossover_chance 1 i bez mutacji
+};
+
+enum class replacement {
+    worst, // dziecko zastepuje najgorszego w populacji
+    tourney, // dziecko zastepuje przegranego z turnieju
+};
+
+enum class topology {
+    ring, // wyspa i wysyla do i + 1
+    random, // do losowej innej wyspy
+};
+
+struct parameters {
+    size_t population_size_ { 100 };
+    uint64_t generations_number_ { 1000 }; // > 0
     double selection_factor_ { 0.5 };
+    selection_type selection_ { selection_type::roulette };
+    bool rank_selection_ { false }; // wagi z rang zamiast z fitnessu
     double elitysm_factor_ { 0.05 };
     size_t genetic_threads_ { 0 };
     double crossover_chance_ { 0.25 };
     double mutate_chance_ { 0.9 };
     double enchance_chance_ { 0.05 };
+    improvement improvement_ { improvement::two_opt };
+    size_t enchance_moves_ { 0 }; // limit ulepszajacych ruchow na dziecko, 0 -> do minimum lokalnego
+    size_t enchance_window_ { 0 }; // okno balas_simonetti, 0 -> domyslne
+
+    bool islands_ { false }; // model wyspowy -- wyspa na watek, kazda z wlasna czescia populacji
+    uint64_t migration_interval_ { 50 }; // co tyle pokolen wyspa wysyla elity do sasiadow
+    size_t migrants_ { 2 };
+    topology topology_ { topology::ring };
+
+    bool steady_state_ { false }; // bez pokolen -- watki na biezaco podmieniaja osobniki we wspolnej populacji
+    replacement replacement_ { replacement::tourney };
+
+    crossover_type crossover_ { crossover_type::random };
+
+    bool unique_ { true }; // dziecko z trasa, ktora juz jest w pokoleniu, jest mutowane ponownie przed ocena
+    bool diversity_ { false }; // co pokolenie wypisuje liczbe roznych tras i srednia odleglosc krawedziowa
 };
 
 constexpr bool ignore_threads = false;
 
+// steady state: rodzic to najlepszy z tylu losowych, a podmieniany jest najgorszy z tylu losowych (replacement::tourney)
+constexpr size_t steady_selection_tourney = 3;
+constexpr size_t steady_replacement_tourney = 3;
+
+// tyle razy duplikat jest mutowany ponownie, potem zostaje jaki jest
+constexpr size_t duplicate_retries = 3;
+
+// dlugosc list kandydatow do sklejania podtras w EAX i local search w enchance
+constexpr size_t eax_neighbours = 10;
+constexpr size_t improvement_neighbours = 10;
+
+// populacja jest dzielona miedzy wyspy, ale zadna nie dostaje mniej osobnikow niz tyle
+constexpr size_t min_island_population = 10;
+
 // TODO moze jakos wyprowadz je na zewnatrz tak aby dalo sie zmieniac je z argumentow
 template </*typename MutationOperator, typename SelectionOperator, typename CrossoverOperator,*/ typename Rng>
 struct solver {
@@ -341,33 +982,69 @@ struct solver {
     Rng rng_;
 
     using MutationOperator = mutation_operator::random_mutation<decltype(rng_)>;
-    // using SelectionOperator = selection_operator::tourney_selection<decltype(rng_), 8>;
-    using SelectionOperator = selection_operator::roulette_wheel_selection<decltype(rng_)>;
+    using TourneySelection = selection_operator::tourney_selection<decltype(rng_), 4>;
     using CrossoverOperator = crossover_operator::random_crossover<decltype(rng_)>;
 
     struct precomputed_parameters {
         size_t population_size_; // = reproduction_number_ + elitysm_number_
         uint64_t generations_;
-        double selection_number_;
+        double selection_factor_;
+        selection_type selection_;
+        bool rank_selection_;
+        double elitysm_factor_;
+        size_t selection_number_;
         double crossover_chance_;
         double mutation_chance_;
         double enchancement_chance_;
+        improvement improvement_;
+        size_t enchancement_moves_;
+        size_t enchancement_window_;
         size_t elitysm_number_;
         size_t reproduction_number_;
         size_t genetic_threads_;
+        bool islands_;
+        uint64_t migration_interval_;
+        size_t migrants_;
+        topology topology_;
+        bool steady_state_;
+        replacement replacement_;
+        crossover_type crossover_;
+        bool unique_;
+        bool diversity_;
 
         precomputed_parameters(parameters const& p)
         {
             // nie chce mi sie pisac ograniczania zakresu
-            population_size_ = p.population_size_;
             generations_ = p.generations_number_;
-            selection_number_ = p.population_size_ * p.selection_factor_;
-            elitysm_number_ = p.population_size_ * p.elitysm_factor_;
-            reproduction_number_ = population_size_ - elitysm_number_;
+            selection_factor_ = p.selection_factor_;
+            selection_ = p.selection_;
+            rank_selection_ = p.rank_selection_;
+            elitysm_factor_ = p.elitysm_factor_;
             genetic_threads_ = p.genetic_threads_ == 0 ? std::thread::hardware_concurrency() : p.genetic_threads_;
             crossover_chance_ = p.crossover_chance_;
             mutation_chance_ = p.mutate_chance_;
             enchancement_chance_ = p.enchance_chance_;
+            improvement_ = p.improvement_;
+            enchancement_moves_ = p.enchance_moves_ == 0 ? std::numeric_limits<size_t>::max() : p.enchance_moves_;
+            enchancement_window_ = p.enchance_window_ == 0 ? balas_simonetti::default_window : p.enchance_window_;
+            islands_ = p.islands_;
+            migration_interval_ = std::max<uint64_t>(1, p.migration_interval_);
+            migrants_ = p.migrants_;
+            topology_ = p.topology_;
+            steady_state_ = p.steady_state_;
+            replacement_ = p.replacement_;
+            crossover_ = p.crossover_;
+            unique_ = p.unique_;
+            diversity_ = p.diversity_;
+            resize(p.population_size_);
+        }
+
+        void resize(size_t population_size)
+        {
+            population_size_ = population_size;
+            selection_number_ = std::max<size_t>(1, population_size_ * selection_factor_);
+            elitysm_number_ = population_size_ * elitysm_factor_;
+            reproduction_number_ = population_size_ - elitysm_number_;
         }
     } const params_;
 
@@ -377,158 +1054,810 @@ struct solver {
     {
     }
 
-    // ale to jest shitcode -- az sie nie poznaje
+    /**
+     * @brief memetyczne ulepszenie dziecka wybrana polityka, z limitem ruchow -- wartosc liczona w miejscu z delt ruchow
+     * @param value wartosc przed ulepszeniem, jezeli jest znana
+     * @return wartosc trasy po ulepszeniu
+     */
+    auto enchance(const ds::heap_matrix<config::value_type>& matrix, chromosome genes, std::optional<config::value_type> value, workspace<Rng>& ws) const
+        -> config::value_type
+    {
+        if (params_.improvement_ == improvement::balas_simonetti) {
+            config::path_type& current_path = ws.path_;
+            current_path.assign(genes.begin(), genes.end());
+            current_path.push_back(genes.front());
+
+            const auto improved = balas_simonetti::improve(matrix, current_path, params_.enchancement_window_);
+            std::copy(current_path.begin(), current_path.end() - 1, genes.begin());
+            return improved;
+        }
+
+        const auto before = value ? *value : calculate_value(matrix, const_chromosome { genes });
+        auto& t = *ws.tour_;
+        auto& optimizer = *ws.optimizer_;
+        t.assign(genes);
+        optimizer.push_all(t);
+        const auto delta = optimizer.run(t, params_.enchancement_moves_);
+        for (std::size_t i {}; i < genes.size(); ++i) {
+            genes[i] = t.at(i);
+        }
+
+        return static_cast<config::value_type>(static_cast<delta_type>(before) + delta);
+    }
+
+    /**
+     * @return zmiana kosztu dziecka wzgledem a, jezeli krzyzowanie ja zna (EAX)
+     */
+    static auto crossover(precomputed_parameters const& p, const_chromosome a, const_chromosome b, chromosome child, workspace<Rng>& ws) -> std::optional<delta_type>
+    {
+        if (p.crossover_ == crossover_type::eax) {
+            return crossover_operator::edge_assembly<Rng>::crossover(a, b, child, ws);
+        }
+
+        CrossoverOperator::crossover(a, b, child, ws);
+        return std::nullopt;
+    }
+
+    /**
+     * @brief dane budowane raz na wywolanie i wspoldzielone przez wszystkie workspace: kontekst EAX i listy kandydatow local search
+     */
+    struct shared_data {
+        const ds::heap_matrix<config::value_type>& matrix_;
+        precomputed_parameters const& params_;
+        bool symmetric_;
+        std::optional<eax::context> eax_ {};
+        std::optional<neighbour_lists> neighbours_ {};
+
+        shared_data(const ds::heap_matrix<config::value_type>& matrix, precomputed_parameters const& params, bool symmetric)
+            : matrix_ { matrix }
+            , params_ { params }
+            , symmetric_ { symmetric }
+        {
+            if (params.crossover_ == crossover_type::eax) {
+                eax_.emplace(matrix, eax_neighbours, symmetric);
+            }
+            if (params.enchancement_chance_ > 0 && params.improvement_ != improvement::balas_simonetti) {
+                neighbours_.emplace(matrix, improvement_neighbours);
+            }
+        }
+
+        void attach(workspace<Rng>& ws) const
+        {
+            ws.eax_context_ = eax_ ? &*eax_ : nullptr;
+            if (neighbours_) {
+                const auto cities = matrix_.size();
+                config::path_type identity(cities + 1);
+                std::iota(identity.begin(), identity.end() - 1, 0);
+                ws.tour_.emplace(identity);
+                // bez 2-opt optimizer robi sam Or-opt
+                ws.optimizer_.emplace(*neighbours_, local_search::matrix_cost { matrix_ }, symmetric_ && params_.improvement_ == improvement::two_opt);
+            }
+        }
+    };
+
+    /**
+     * @brief czesciowo posortuje indeksy od najlepszego -- optymalizacja dla elitaryzmu
+     * i dzieki temu tez mamy darmowy best
+     */
+    static void rank(population& current, std::vector<uint32_t>& order, size_t elites)
+    {
+        std::iota(order.begin(), order.end(), 0);
+        auto less = [&current](uint32_t l, uint32_t r) {
+            return current.fitness_[l] < current.fitness_[r];
+        };
+        std::partial_sort(order.begin(), order.begin() + std::max<size_t>(1, elites), order.end(), less);
+        for (size_t r {}; r < order.size(); ++r) {
+            current.rank_[order[r]] = static_cast<uint32_t>(r);
+        }
+    }
+
+    /**
+     * @brief Step 3 -- dla ruletki tylko tablica aliasow, z ktorej watki same losuja rodzicow, inaczej pula selected
+     * @return tablica do losowania albo nullptr, jezeli rodzice sa w selected
+     */
+    static auto select(precomputed_parameters const& p, population const& current, std::span<uint32_t> selected, selection_scratch& scratch, Rng& rng)
+        -> const utils::alias_table*
+    {
+        switch (p.selection_) {
+        case selection_type::roulette:
+            selection_operator::roulette_wheel_selection::prepare(current, scratch, p.rank_selection_);
+            return &scratch.table_;
+        case selection_type::sus:
+            selection_operator::stochastic_universal_sampling<Rng>::select(current, selected, scratch, p.rank_selection_, rng);
+            return nullptr;
+        case selection_type::tourney:
+            TourneySelection::select(current, selected, scratch, p.rank_selection_, rng);
+            return nullptr;
+        }
+        throw std::runtime_error { "nieznana selekcja" };
+    }
+
+    /**
+     * @brief dzieci od first co step (sloty za elitami) -- wszystko na buforach i generatorze z ws
+     */
+    void breed(
+        const ds::heap_matrix<config::value_type>& matrix,
+        precomputed_parameters const& p,
+        population& current,
+        population& next,
+        std::span<const uint32_t> selected,
+        const utils::alias_table* table,
+        hash_set* hashes,
+        workspace<Rng>& ws,
+        size_t first,
+        size_t step,
+        bool symmetric) const
+    {
+        std::uniform_int_distribution<size_t> index_distr(0, selected.size() - 1);
+        std::uniform_real_distribution<> distr {};
+        // ruletka losuje rodzica od razu z tablicy aliasow, pozostale selekcje z puli
+        auto parent = [&]() -> uint32_t {
+            return table ? table->draw(ws.rng_) : selected[index_distr(ws.rng_)];
+        };
+
+        for (size_t i = first; i < p.reproduction_number_; i += step) {
+            const auto slot = p.elitysm_number_ + i;
+            auto child = next.at(slot);
+            // znany bez pelnej oceny: kopia rodzica -- jego fitness plus zmiana kosztu z mutacji
+            std::optional<config::value_type> fitness {};
+
+            if (distr(ws.rng_) < p.crossover_chance_) {
+                auto ind_a = parent();
+                auto ind_b = parent();
+
+                const auto delta = crossover(p, current.at(ind_a), current.at(ind_b), child, ws);
+                next.parents_[slot] = { ind_a, ind_b };
+                if (delta) {
+                    fitness = static_cast<config::value_type>(static_cast<delta_type>(current.fitness_[ind_a]) + *delta);
+                }
+
+                if (distr(ws.rng_) < p.mutation_chance_) {
+                    // dziecka nie ma w populacji -- bez sum prefiksowych delta mutacji jest znana tylko dla STSP
+                    if (fitness && symmetric) {
+                        const mutation_operator::delta_context context { matrix, symmetric };
+                        *fitness += MutationOperator::mutate(child, ws.rng_, &context);
+                    } else {
+                        MutationOperator::mutate(child, ws.rng_);
+                        fitness.reset();
+                    }
+                }
+            } else {
+                auto ind = parent();
+                const auto parent = current.at(ind);
+                std::copy(parent.begin(), parent.end(), child.begin());
+                next.parents_[slot] = { ind, ind };
+                fitness = current.fitness_[ind];
+
+                if (distr(ws.rng_) < p.mutation_chance_) {
+                    const mutation_operator::delta_context context { matrix, symmetric, &current, ind };
+                    *fitness += MutationOperator::mutate(child, ws.rng_, &context);
+                }
+            }
+
+            // trasa, ktora juz jest w tym pokoleniu, jest mutowana ponownie zanim zostanie oceniona
+            auto hash = tour_hash(child, symmetric);
+            for (size_t retry {}; hashes && !hashes->insert(hash) && retry < duplicate_retries; ++retry) {
+                MutationOperator::mutate(child, ws.rng_);
+                fitness.reset();
+                hash = tour_hash(child, symmetric);
+            }
+
+            if (distr(ws.rng_) < p.enchancement_chance_) {
+                fitness = enchance(matrix, child, fitness, ws);
+
+                // local search czesto zbiega do tego samego minimum -- wtedy zostaje tylko zmutowane minimum
+                const auto improved = tour_hash(child, symmetric);
+                if (hashes && improved != hash && !hashes->insert(improved)) {
+                    MutationOperator::mutate(child, ws.rng_);
+                    fitness.reset();
+                    hash = tour_hash(child, symmetric);
+                } else {
+                    hash = improved;
+                }
+            }
+            next.hash_[slot] = hash;
+
+            if (fitness) {
+                next.fitness_[slot] = *fitness;
+                next.invalidate(slot);
+            } else {
+                // dziecko jest jeszcze w cache tego watku
+                next.evaluate(slot, matrix);
+            }
+        }
+    }
+
+    /**
+     * @brief dzieki czesciowemu posortowaniu w rank() elity to pierwsze indeksy z order
+     */
+    static void keep_elites(precomputed_parameters const& p, population const& current, population& next, std::vector<uint32_t> const& order)
+    {
+        for (size_t i {}; i < p.elitysm_number_; ++i) {
+            next.assign(i, current, order[i]);
+            next.parents_[i] = { order[i], order[i] };
+        }
+    }
+
+    /**
+     * @brief elity przechodza do nastepnego pokolenia bez zmian -- ich trasy sa w zbiorze zanim zaczna sie rodzic dzieci
+     */
+    static void seed_hashes(precomputed_parameters const& p, population const& current, std::vector<uint32_t> const& order, hash_set& hashes)
+    {
+        hashes.clear();
+        for (size_t i {}; i < p.elitysm_number_; ++i) {
+            hashes.insert(current.hash_[order[i]]);
+        }
+    }
+
+    struct diversity_scratch {
+        std::vector<uint64_t> hashes_ {};
+        std::vector<uint32_t> next_ {};
+        std::vector<uint32_t> prev_ {};
+    };
+
+    /**
+     * @brief liczba roznych tras (po skrotach) i srednia odleglosc krawedziowa (krawedzie jednej trasy, ktorych nie ma druga)
+     * miedzy osobnikami i oraz i + 1 -- O(P n) zamiast wszystkich par
+     */
+    static void report_diversity(population const& current, diversity_scratch& scratch, bool symmetric, std::string_view label, uint64_t generation)
+    {
+        const auto size = current.size();
+        const auto cities = current.cities();
+
+        scratch.hashes_.assign(current.hash_.begin(), current.hash_.end());
+        std::sort(scratch.hashes_.begin(), scratch.hashes_.end());
+        const auto distinct = static_cast<size_t>(std::unique(scratch.hashes_.begin(), scratch.hashes_.end()) - scratch.hashes_.begin());
+
+        scratch.next_.resize(cities);
+        scratch.prev_.resize(cities);
+        uint64_t distance {};
+        for (size_t i {}; i < size && size > 1; ++i) {
+            const auto a = current.at(i);
+            const auto b = current.at((i + 1) % size);
+            for (size_t k {}; k < cities; ++k) {
+                scratch.next_[a[k]] = a[k + 1 == cities ? 0 : k + 1];
+                scratch.prev_[a[k]] = a[k == 0 ? cities - 1 : k - 1];
+            }
+            for (size_t k {}; k < cities; ++k) {
+                const auto from = b[k];
+                const auto to = b[k + 1 == cities ? 0 : k + 1];
+                distance += scratch.next_[from] != to && !(symmetric && scratch.prev_[from] == to);
+            }
+        }
+
+        std::cout << "genetic" << label << ": pokolenie " << generation << ", rozne trasy " << distinct << '/' << size
+                  << ", srednia odleglosc krawedziowa " << static_cast<double>(distance) / static_cast<double>(std::max<size_t>(1, size)) << '\n';
+    }
+
     auto operator()(
         const ds::heap_matrix<config::value_type>& matrix,
         const config::path_type& starting_path)
         -> config::path_type
     {
-        config::path_type best_solution {};
+        const auto cities = starting_path.size() - 1;
+        if (cities < 2 || params_.population_size_ == 0) {
+            return starting_path;
+        }
+
+        if (params_.islands_) {
+            return islands(matrix, starting_path);
+        }
+        if (params_.steady_state_) {
+            return steady_state(matrix, starting_path);
+        }
+        return generational(matrix, starting_path);
+    }
+
+    // ale to jest shitcode -- az sie nie poznaje
+    auto generational(
+        const ds::heap_matrix<config::value_type>& matrix,
+        const config::path_type& starting_path)
+        -> config::path_type
+    {
+        const auto cities = starting_path.size() - 1;
+
+        // wszystko co potrzebne w petli jest allokowane tutaj, pokolenia tylko nadpisuja te bufory
+        const bool symmetric = is_symmetric(matrix);
+        population current { params_.population_size_, cities, symmetric };
+        population next { params_.population_size_, cities, symmetric };
+        std::vector<uint32_t> order(params_.population_size_);
+        std::vector<uint32_t> selected(params_.selection_number_);
+        selection_scratch scratch { params_.population_size_ };
+        hash_set hashes { params_.population_size_ };
+        hash_set* unique = params_.unique_ ? &hashes : nullptr;
+        diversity_scratch diversity {};
+
+        std::vector<city_type> best_solution(starting_path.begin(), starting_path.end() - 1);
         std::optional<config::value_type> best_value_opt {};
 
+        // kazdy task rozmnaza co tasks-te dziecko na swoich buforach i swoim generatorze
+        const auto tasks = std::max<size_t>(1, std::min(params_.genetic_threads_, params_.reproduction_number_));
+        std::vector<workspace<Rng>> workspaces {};
+        workspaces.reserve(tasks);
+        const shared_data shared { matrix, params_, symmetric };
+        for (size_t t {}; t < tasks; ++t) {
+            workspaces.emplace_back(cities, Rng { rng_() });
+            shared.attach(workspaces.back());
+        }
+        std::vector<std::future<void>> futures {};
+        futures.reserve(tasks);
+
         utils::thread_pool pool { params_.genetic_threads_ };
 
         // Step 1. Create an initial population of P chromosomes.
-        std::vector<config::path_type> population = create_initial_population<MutationOperator>(starting_path, params_.population_size_, rng_);
+        create_initial_population<MutationOperator>(best_solution, current, rng_);
 
-        for (uint64_t generation {}; generation < params_.generations_; ++generation) {
+        // Step 2. Evaluate the fitness of each chromosome.
+        // pozniej fitness liczy task, ktory stworzyl dziecko -- kolejne pokolenie zaczyna sie z gotowym fitnessem
+        for (size_t i {}; i < params_.population_size_; ++i) {
+            current.evaluate(i, matrix);
+            current.rehash(i);
+        }
 
-            // Step 2. Evaluate the fitness of each chromosome.
-            std::vector<config::value_type> fitness_values(params_.population_size_);
-            {
-                // std::vector<std::future<void>> futures {};
-                // futures.reserve(params_.population_size_);
-                for (size_t i {}; i < params_.population_size_; ++i) {
-                    auto evaluate_nth = [&fitness_values, &population, &matrix, i]() {
-                        fitness_values[i] = calculate_value(matrix, population[i]);
-                    };
+        auto report = [&current, &order, &best_solution, &best_value_opt](uint64_t generation) {
+            if (!best_value_opt || current.fitness_[order[0]] < *best_value_opt) {
+                const auto genes = current.at(order[0]);
+                std::copy(genes.begin(), genes.end(), best_solution.begin());
+                best_value_opt = current.fitness_[order[0]];
 
-                    // nie oplaca sie dodawac 2 punktow synchronizacji miedzy threadami dla liczenia tego wielowatkowo
-                    // wykonuje sie dluzej
-                    // if constexpr (ignore_threads) {
-                    evaluate_nth();
-                    // } else {
-                    //     futures.push_back(pool.queue(evaluate_nth));
-                    // }
+                auto instance = prd_printer::instance();
+                if (instance) {
+                    instance->print(generation, *best_value_opt);
                 }
-                // for (auto& future : futures) {
-                //     future.wait();
-                // }
             }
+        };
 
-            // NOTE czesciowo posortuje populacje od najlepszego i odpowiadajacy fitness -- optymalizacja dla elitaryzmu
-            // i dzieki temu tez mamy darmowy best
-            {
-                auto less = [](decltype(fitness_values)::value_type const& l, decltype(fitness_values)::value_type const& r) {
-                    return l < r;
-                };
+        bool stopped = false;
+        for (uint64_t generation {}; generation < params_.generations_; ++generation) {
+            rank(current, order, params_.elitysm_number_);
+            report(generation);
+            if (lower_bound::should_stop(*best_value_opt)) {
+                stopped = true;
+                break;
+            }
 
-                auto permutation = partial_sort_permutation(fitness_values, params_.elitysm_number_, less);
-                population = apply_permutation(population, permutation);
-                fitness_values = apply_permutation(fitness_values, permutation);
+            // Step 3. Choose P/2 parents from the current population via proportional selection.
+            if (params_.diversity_) {
+                report_diversity(current, diversity, symmetric, "", generation);
+            }
+
+            const auto* table = select(params_, current, selected, scratch, rng_);
+            if (unique) {
+                seed_hashes(params_, current, order, *unique);
             }
+
+            // Step 4. Randomly select two parents to create offspring using crossover operator.
+            // Step 5. Apply mutation operators for minor changes in the results.
             {
-                if (!best_value_opt || fitness_values[0] < *best_value_opt) {
-                    best_solution = population[0];
-                    best_value_opt = fitness_values[0];
+                futures.clear();
+
+                for (size_t t {}; t < tasks; ++t) {
+                    auto reproduce_nth = [&matrix, &current, &next, &selected, table, unique, &workspaces, this, t, tasks, symmetric]() {
+                        breed(matrix, params_, current, next, selected, table, unique, workspaces[t], t, tasks, symmetric);
+                    };
+                    if constexpr (ignore_threads) {
+                        reproduce_nth();
+                    } else {
+                        futures.push_back(pool.queue(reproduce_nth));
+                    }
+                }
+                for (auto& future : futures) {
+                    future.get();
+                }
+            }
+
+            // Step 6. Repeat Steps  4 and 5 until all parents are selected and mated.
+            // jescze dodam elityzm
+            keep_elites(params_, current, next, order);
+
+            std::swap(current, next);
+        }
+
+        // ostatnie pokolenie tez moze miec najlepsza trase
+        if (!stopped) {
+            rank(current, order, 1);
+            report(params_.generations_);
+        }
+
+        config::path_type best_path(best_solution.begin(), best_solution.end());
+        best_path.push_back(best_path.front());
+        return best_path;
+    }
+
+    struct migrant {
+        std::vector<city_type> genes_ {};
+        config::value_type fitness_ {};
+    };
+
+    /**
+     * @brief wyspa -- wlasna czesc populacji, bufory i generator, pokolenia bez czekania na inne wyspy
+     */
+    struct island {
+        population current_;
+        population next_;
+        std::vector<uint32_t> order_;
+        std::vector<uint32_t> selected_;
+        selection_scratch selection_scratch_;
+        hash_set hashes_;
+        diversity_scratch diversity_ {};
+        workspace<Rng> ws_;
+        utils::bounded_queue<migrant> inbox_;
+
+        island(precomputed_parameters const& p, size_t cities, bool symmetric, Rng const& rng)
+            : current_ { p.population_size_, cities, symmetric }
+            , next_ { p.population_size_, cities, symmetric }
+            , order_(p.population_size_)
+            , selected_(p.selection_number_)
+            , selection_scratch_(p.population_size_)
+            , hashes_ { p.population_size_ }
+            , ws_ { cities, rng }
+            , inbox_ { 4 * std::max<size_t>(1, p.migrants_), [cities](migrant& m) { m.genes_.resize(cities); } }
+        {
+        }
+    };
+
+    /**
+     * @brief model wyspowy: kazdy watek ma swoja wyspe z czescia populacji i liczy pokolenia bez barier miedzy watkami
+     * co migration_interval_ pokolen wyspa wysyla migrants_ najlepszych do sasiada (ring) albo losowej wyspy (random)
+     * przez ograniczona kolejke bez blokad -- jak jest pelna, migrant przepada. przybysze zastepuja najgorszych
+     */
+    auto islands(
+        const ds::heap_matrix<config::value_type>& matrix,
+        const config::path_type& starting_path)
+        -> config::path_type
+    {
+        const auto cities = starting_path.size() - 1;
+        const bool symmetric = is_symmetric(matrix);
+        const auto count = std::max<size_t>(1, params_.genetic_threads_);
+
+        auto p = params_;
+        p.resize(std::max(min_island_population, params_.population_size_ / count));
+        if (p.reproduction_number_ == 0) {
+            p.resize(p.population_size_ + 1);
+        }
+
+        const shared_data shared { matrix, p, symmetric };
+        std::vector<std::unique_ptr<island>> archipelago {};
+        archipelago.reserve(count);
+        for (size_t i {}; i < count; ++i) {
+            archipelago.push_back(std::make_unique<island>(p, cities, symmetric, Rng { rng_() }));
+            shared.attach(archipelago.back()->ws_);
+        }
+
+        const std::vector<city_type> start(starting_path.begin(), starting_path.end() - 1);
+        std::vector<city_type> best_solution = start;
+        std::atomic<config::value_type> best_value { std::numeric_limits<config::value_type>::max() };
+        std::mutex best_mutex {};
+        std::atomic<bool> stop { false };
+
+        auto report = [&](population const& current, uint32_t index, uint64_t generation) {
+            const auto value = current.fitness_[index];
+            if (value < best_value.load(std::memory_order_relaxed)) {
+                std::unique_lock<std::mutex> l(best_mutex);
+                if (value < best_value.load(std::memory_order_relaxed)) {
+                    const auto genes = current.at(index);
+                    std::copy(genes.begin(), genes.end(), best_solution.begin());
+                    best_value.store(value, std::memory_order_relaxed);
 
                     auto instance = prd_printer::instance();
                     if (instance) {
-                        instance->print(generation, *best_value_opt);
+                        instance->print(generation, value);
                     }
                 }
             }
+            if (lower_bound::should_stop(best_value.load(std::memory_order_relaxed))) {
+                stop = true;
+            }
+        };
 
-            // Step 3. Choose P/2 parents from the current population via proportional selection.
-            auto selected = SelectionOperator::select(population, fitness_values, params_.selection_number_, rng_);
-            // NOTE roulette_wheel_selection nie da sie urownoleglic, musi stworzyc lookup table z prawdopodobienstwami
-            // FIXME mozna preallocowac selected aby oszczedzic na allokacji
+        auto migrate = [&](size_t index) {
+            auto& self = *archipelago[index];
 
-            // Step 4. Randomly select two parents to create offspring using crossover operator.
-            // Step 5. Apply mutation operators for minor changes in the results.
-            std::vector<config::path_type> reproduced(params_.reproduction_number_);
-            {
-                std::vector<std::future<void>> futures {};
-                futures.reserve(params_.reproduction_number_);
+            // przybysze na miejsce najgorszych
+            while (self.inbox_.try_pop([&self](migrant& m) {
+                const auto worst = std::max_element(self.current_.fitness_.begin(), self.current_.fitness_.end());
+                self.current_.assign(static_cast<size_t>(worst - self.current_.fitness_.begin()), m.genes_, m.fitness_);
+            })) { }
 
-                for (size_t i {}; i < params_.reproduction_number_; ++i) {
+            if (count < 2) {
+                return;
+            }
 
-                    Rng thread_rng { rng_() };
-                    auto reproduce_nth = [&matrix, &reproduced, &selected, this, thread_rng, i]() mutable {
-                        std::uniform_int_distribution<> index_distr(0, params_.selection_number_ - 1);
-                        std::uniform_real_distribution<> distr {};
-                        if (distr(rng_) < params_.crossover_chance_) {
-                            auto ind_a = index_distr(thread_rng);
-                            auto ind_b = index_distr(thread_rng);
+            rank(self.current_, self.order_, std::max(p.elitysm_number_, p.migrants_));
+            std::uniform_int_distribution<size_t> other_distr(1, count - 1);
+            for (size_t i {}; i < std::min(p.migrants_, p.population_size_); ++i) {
+                const auto target = p.topology_ == topology::ring ? (index + 1) % count : (index + other_distr(self.ws_.rng_)) % count;
+                const auto genes = self.current_.at(self.order_[i]);
+                const auto fitness = self.current_.fitness_[self.order_[i]];
+                archipelago[target]->inbox_.try_push([&](migrant& m) {
+                    std::copy(genes.begin(), genes.end(), m.genes_.begin());
+                    m.fitness_ = fitness;
+                });
+            }
+        };
 
-                            reproduced[i] = CrossoverOperator::crossover(*selected[ind_a], *selected[ind_b], thread_rng);
-                        } else {
-                            auto ind = index_distr(thread_rng);
-                            reproduced[i] = *selected[ind];
-                        }
+        auto run = [&](size_t index) {
+            auto& self = *archipelago[index];
 
-                        if (distr(rng_) < params_.mutation_chance_) {
-                            MutationOperator::mutate(reproduced[i], thread_rng);
-                        }
+            create_initial_population<MutationOperator>(start, self.current_, self.ws_.rng_);
+            for (size_t i {}; i < p.population_size_; ++i) {
+                self.current_.evaluate(i, matrix);
+                self.current_.rehash(i);
+            }
+            const auto label = " (wyspa " + std::to_string(index) + ")";
 
-                        if (distr(rng_) < params_.enchancement_chance_) {
-                            config::path_type& current_path = reproduced[i];
-                            config::value_type current_value = calculate_value(matrix, current_path);
+            for (uint64_t generation {}; generation < p.generations_ && !stop.load(std::memory_order_relaxed); ++generation) {
+                if (generation % p.migration_interval_ == 0 && generation != 0) {
+                    migrate(index);
+                }
+
+                rank(self.current_, self.order_, p.elitysm_number_);
+                report(self.current_, self.order_[0], generation);
+
+                if (p.diversity_) {
+                    report_diversity(self.current_, self.diversity_, symmetric, label, generation);
+                }
 
-                            config::path_type surrounding_path {};
-                            surrounding_path.reserve(current_path.size());
-                            config::value_type surrounding_value = current_value;
+                const auto* table = select(p, self.current_, self.selected_, self.selection_scratch_, self.ws_.rng_);
+                if (p.unique_) {
+                    seed_hashes(p, self.current_, self.order_, self.hashes_);
+                }
+                breed(matrix, p, self.current_, self.next_, self.selected_, table, p.unique_ ? &self.hashes_ : nullptr, self.ws_, 0, 1, symmetric);
+                keep_elites(p, self.current_, self.next_, self.order_);
 
-                            config::path_type best_path {};
-                            best_path.reserve(current_path.size());
-                            std::optional<config::value_type> best_value {};
+                std::swap(self.current_, self.next_);
+            }
 
-                            surroundings::swap surrounding_generator { matrix, current_path, current_value, surrounding_path, surrounding_value };
-                            while (surrounding_generator.valid()) {
-                                surrounding_generator.calculate();
+            // ostatnie pokolenie tez moze miec najlepsza trase
+            rank(self.current_, self.order_, 1);
+            report(self.current_, self.order_[0], p.generations_);
+        };
 
-                                if (!best_value || (best_value && surrounding_value < *best_value)) {
-                                    best_value = surrounding_value;
-                                    best_path = surrounding_path;
-                                }
+        {
+            utils::thread_pool pool { count };
+            std::vector<std::future<void>> futures {};
+            for (size_t i {}; i < count; ++i) {
+                futures.push_back(pool.queue([&run, i]() { run(i); }));
+            }
+            for (auto& future : futures) {
+                future.get();
+            }
+        }
 
-                                surrounding_generator.next();
-                            }
+        config::path_type best_path(best_solution.begin(), best_solution.end());
+        best_path.push_back(best_path.front());
+        return best_path;
+    }
 
-                            current_path = best_path;
-                            // NOTE ignoruje znaleziony value
+    /**
+     * @brief bufory watku steady state -- rodzice sa kopiowani ze wspolnej populacji, dziecko powstaje poza nia
+     */
+    struct steady_worker {
+        workspace<Rng> ws_;
+        std::vector<city_type> parent_a_;
+        std::vector<city_type> parent_b_;
+        std::vector<city_type> child_;
+
+        steady_worker(size_t cities, Rng const& rng)
+            : ws_ { cities, rng }
+            , parent_a_(cities)
+            , parent_b_(cities)
+            , child_(cities)
+        {
+        }
+    };
+
+    /**
+     * @brief steady state: kazdy watek w petli wybiera rodzicow, rozmnaza, ocenia i od razu podmienia osobnika
+     * we wspolnej populacji -- bez barier miedzy pokoleniami, wiec szybki watek nie czeka na wolny enchance innego
+     * osobnik jest chroniony wlasna blokada (tylko na czas kopiowania genow), fitness czytany bez blokad przez atomic_ref
+     * dziecko wchodzi tylko na miejsce gorszego od siebie, wiec najlepszy osobnik nigdy nie ginie.
+     * liczba urodzen jest taka sama jak w wersji pokoleniowej: generations * reproduction_number
+     */
+    auto steady_state(
+        const ds::heap_matrix<config::value_type>& matrix,
+        const config::path_type& starting_path)
+        -> config::path_type
+    {
+        const auto cities = starting_path.size() - 1;
+        const auto size = params_.population_size_;
+        const bool symmetric = is_symmetric(matrix);
+
+        population shared { size, cities, symmetric };
+        const auto locks = std::make_unique<std::atomic_flag[]>(size);
+
+        std::vector<city_type> best_solution(starting_path.begin(), starting_path.end() - 1);
+        std::atomic<config::value_type> best_value { std::numeric_limits<config::value_type>::max() };
+        std::mutex best_mutex {};
+
+        create_initial_population<MutationOperator>(best_solution, shared, rng_);
+        for (size_t i {}; i < size; ++i) {
+            shared.evaluate(i, matrix);
+            shared.rehash(i);
+        }
+
+        const auto births_limit = params_.generations_ * std::max<size_t>(1, params_.reproduction_number_);
+        std::atomic<uint64_t> births { 0 };
+        std::atomic<bool> stop { false };
+
+        auto fitness = [&shared](size_t index) {
+            return std::atomic_ref<config::value_type>(shared.fitness_[index]).load(std::memory_order_relaxed);
+        };
+
+        // skroty sa podmieniane razem z osobnikiem, ale czytane bez blokady -- sprawdzenie duplikatu jest przyblizone
+        auto duplicate = [&shared, size](uint64_t hash) {
+            for (size_t i {}; i < size; ++i) {
+                if (std::atomic_ref<uint64_t>(shared.hash_[i]).load(std::memory_order_relaxed) == hash) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto report = [&](const_chromosome genes, config::value_type value) {
+            if (value < best_value.load(std::memory_order_relaxed)) {
+                std::unique_lock<std::mutex> l(best_mutex);
+                if (value < best_value.load(std::memory_order_relaxed)) {
+                    std::copy(genes.begin(), genes.end(), best_solution.begin());
+                    best_value.store(value, std::memory_order_relaxed);
+
+                    auto instance = prd_printer::instance();
+                    if (instance) {
+                        instance->print(births.load(std::memory_order_relaxed) / size, value);
+                    }
+                }
+            }
+            if (lower_bound::should_stop(best_value.load(std::memory_order_relaxed))) {
+                stop = true;
+            }
+        };
+
+        {
+            const auto best = static_cast<size_t>(std::min_element(shared.fitness_.begin(), shared.fitness_.end()) - shared.fitness_.begin());
+            report(shared.at(best), shared.fitness_[best]);
+        }
+
+        auto lock = [&locks](size_t index) {
+            while (locks[index].test_and_set(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        };
+        auto unlock = [&locks](size_t index) {
+            locks[index].clear(std::memory_order_release);
+        };
+
+        auto work = [&](steady_worker& w) {
+            auto& rng = w.ws_.rng_;
+            std::uniform_int_distribution<size_t> index_distr(0, size - 1);
+            std::uniform_real_distribution<> distr {};
+
+            auto pick = [&](bool best) {
+                auto chosen = index_distr(rng);
+                for (size_t i = 1; i < (best ? steady_selection_tourney : steady_replacement_tourney); ++i) {
+                    const auto other = index_distr(rng);
+                    if (best ? fitness(other) < fitness(chosen) : fitness(chosen) < fitness(other)) {
+                        chosen = other;
+                    }
+                }
+                return chosen;
+            };
+
+            auto copy_out = [&](size_t index, std::vector<city_type>& to) {
+                lock(index);
+                const auto genes = shared.at(index);
+                std::copy(genes.begin(), genes.end(), to.begin());
+                const auto value = shared.fitness_[index];
+                unlock(index);
+                return value;
+            };
+
+            while (!stop.load(std::memory_order_relaxed) && births.fetch_add(1, std::memory_order_relaxed) < births_limit) {
+                // wartosc dziecka bez pelnej oceny: kopia rodzica ze zmiana kosztu z mutacji albo wynik enchance
+                config::value_type child_value {};
+                bool known = false;
+
+                const auto value_a = copy_out(pick(true), w.parent_a_);
+                if (distr(rng) < params_.crossover_chance_) {
+                    copy_out(pick(true), w.parent_b_);
+                    const auto delta = crossover(params_, w.parent_a_, w.parent_b_, w.child_, w.ws_);
+                    if (delta) {
+                        child_value = static_cast<config::value_type>(static_cast<delta_type>(value_a) + *delta);
+                        known = true;
+                    }
+                    if (distr(rng) < params_.mutation_chance_) {
+                        if (known && symmetric) {
+                            const mutation_operator::delta_context context { matrix, symmetric };
+                            child_value += MutationOperator::mutate(w.child_, rng, &context);
+                        } else {
+                            MutationOperator::mutate(w.child_, rng);
+                            known = false;
+                        }
+                    }
+                } else {
+                    std::copy(w.parent_a_.begin(), w.parent_a_.end(), w.child_.begin());
+                    child_value = value_a;
+                    known = true;
+                    if (distr(rng) < params_.mutation_chance_) {
+                        // rodzic nie jest juz w populacji -- bez sum prefiksowych delta jest znana tylko dla STSP
+                        if (symmetric) {
+                            const mutation_operator::delta_context context { matrix, symmetric };
+                            child_value += MutationOperator::mutate(w.child_, rng, &context);
+                        } else {
+                            MutationOperator::mutate(w.child_, rng);
+                            known = false;
                         }
-                    };
-                    if constexpr (ignore_threads) {
-                        reproduce_nth();
-                    } else {
-                        futures.push_back(pool.queue(reproduce_nth));
                     }
                 }
-                for (auto& future : futures) {
-                    future.wait();
+
+                auto hash = tour_hash(w.child_, symmetric);
+                for (size_t retry {}; params_.unique_ && retry < duplicate_retries && duplicate(hash); ++retry) {
+                    MutationOperator::mutate(w.child_, rng);
+                    known = false;
+                    hash = tour_hash(w.child_, symmetric);
                 }
-            }
 
-            // Step 6. Repeat Steps  4 and 5 until all parents are selected and mated.
-            // jescze dodam elityzm
-            std::vector<config::path_type> elityst(params_.elitysm_number_);
-            {
-                // dzieki czesciowemu posortowaniu na poczatku wystarczy ze nie usuniemy kilku pierwszych i mamy elityzm, ale i tak zrobie movem dla czytelnosci
-                for (size_t i {}; i < params_.elitysm_number_; ++i) {
-                    elityst[i] = std::move(population[i]);
-                    // TODO optymalizacja mozna jakos tez skopiowac fitness elitystow zeby go nie rekalkulowac
+                if (distr(rng) < params_.enchancement_chance_) {
+                    child_value = enchance(matrix, w.child_, known ? std::optional { child_value } : std::nullopt, w.ws_);
+                    known = true;
+                    hash = tour_hash(w.child_, symmetric);
+                }
+                if (!known) {
+                    child_value = calculate_value(matrix, const_chromosome { w.child_ });
+                }
+
+                // kopia trasy, ktora juz jest w populacji, tylko wypchnelaby inny osobnik
+                if (params_.unique_ && duplicate(hash)) {
+                    report(w.child_, child_value);
+                    continue;
+                }
+
+                size_t victim {};
+                if (params_.replacement_ == replacement::worst) {
+                    for (size_t i = 1; i < size; ++i) {
+                        if (fitness(victim) < fitness(i)) {
+                            victim = i;
+                        }
+                    }
+                } else {
+                    victim = pick(false);
+                }
+
+                lock(victim);
+                if (child_value < shared.fitness_[victim]) {
+                    std::copy(w.child_.begin(), w.child_.end(), shared.at(victim).begin());
+                    std::atomic_ref<config::value_type>(shared.fitness_[victim]).store(child_value, std::memory_order_relaxed);
+                    std::atomic_ref<uint64_t>(shared.hash_[victim]).store(hash, std::memory_order_relaxed);
+                    shared.invalidate(victim);
                 }
+                unlock(victim);
+
+                report(w.child_, child_value);
             }
+        };
+
+        const auto threads = std::max<size_t>(1, params_.genetic_threads_);
+        const shared_data data { matrix, params_, symmetric };
+        std::vector<steady_worker> workers {};
+        workers.reserve(threads);
+        for (size_t t {}; t < threads; ++t) {
+            workers.emplace_back(cities, Rng { rng_() });
+            data.attach(workers.back().ws_);
+        }
 
-            for (size_t i {}; i < params_.elitysm_number_; ++i) {
-                population[i] = std::move(elityst[i]);
+        {
+            utils::thread_pool pool { threads };
+            std::vector<std::future<void>> futures {};
+            for (auto& w : workers) {
+                futures.push_back(pool.queue([&work, &w]() { work(w); }));
             }
-            for (size_t i {}; i < params_.reproduction_number_; ++i) {
-                population[i + params_.elitysm_number_] = std::move(reproduced[i]);
+            for (auto& future : futures) {
+                future.get();
             }
         }
-        return best_solution;
+
+        config::path_type best_path(best_solution.begin(), best_solution.end());
+        best_path.push_back(best_path.front());
+        return best_path;
     }
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "local_search.hpp"
+#include "lower_bound.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+#include "solver/prdprinter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tsp::solver::gls {
+
+struct parameters {
+    uint64_t iterations_ { 100000 }; // liczba lokalnych minimow z nakladanymi karami
+    uint64_t time_limit_ { 0 }; // milisekundy, 0 -> tylko limit iteracji
+    std::size_t neighbours_ { 10 }; // dlugosc list kandydatow
+    double alpha_ { 0.3 }; // lambda = alpha * koszt pierwszego minimum / n
+};
+
+/**
+ * @brief koszt krawedzi z kara: d(a, b) + lambda * p(a, b) -- podstawiany do optimizer zamiast matrix_cost,
+ * wiec ruchy sa oceniane tymi samymi wzorami O(1) co zwykly local search
+ */
+struct penalized_cost {
+    const ds::heap_matrix<config::value_type>& matrix_;
+    const ds::heap_matrix<uint32_t>& penalties_;
+    local_search::delta_type lambda_ {};
+
+    auto operator()(uint32_t from, uint32_t to) const -> local_search::delta_type
+    {
+        return static_cast<local_search::delta_type>(matrix_.at(from, to)) + lambda_ * penalties_.at(from, to);
+    }
+};
+
+/**
+ * @brief guided local search: 2-opt + Or-opt (sam Or-opt dla ATSP) z don't-look bits na koszcie z karami
+ * w kazdym lokalnym minimum karane sa krawedzie trasy o najwiekszej uzytecznosci d / (1 + p), a do kolejki
+ * trafiaja tylko ich konce -- kolejne minimum jest szukane lokalnie wokol nich. wynik to najlepsza trasa wg prawdziwego kosztu
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& starting_path, const parameters& params = {})
+    -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 8) {
+        return starting_path;
+    }
+
+    const bool symmetric = is_symmetric(matrix);
+    const neighbour_lists neighbours { matrix, params.neighbours_ };
+    ds::heap_matrix<uint32_t> penalties { size };
+    local_search::optimizer optimizer { neighbours, penalized_cost { matrix, penalties }, symmetric };
+    local_search::tour t { starting_path };
+
+    // bez kar to zwykly local search -- jego minimum wyznacza skale lambdy
+    optimizer.push_all(t);
+    auto best = static_cast<local_search::delta_type>(calculate_value(matrix, starting_path)) + optimizer.run(t);
+    auto best_path = t.to_path(static_cast<uint32_t>(starting_path[0]));
+    optimizer.cost().lambda_ = std::max<local_search::delta_type>(1,
+        std::llround(params.alpha_ * static_cast<double>(best) / static_cast<double>(size)));
+
+    std::vector<uint32_t> penalized {};
+
+    // prawdziwy koszt minimum i krawedzie o najwiekszej uzytecznosci w jednym przejsciu -- zaraz po kazdym run(),
+    // wiec ostatnie minimum tez jest porownane z najlepszym. zwraca true, jak osiagnieto dolne ograniczenie
+    auto inspect = [&](uint64_t iteration) -> bool {
+        local_search::delta_type value {};
+        double utility {};
+        penalized.clear();
+        for (std::size_t i {}; i < size; ++i) {
+            const auto from = t.at(i);
+            const auto to = t.at(i + 1);
+            const auto distance = matrix.at(from, to);
+            value += static_cast<local_search::delta_type>(distance);
+
+            const auto u = static_cast<double>(distance) / (1. + penalties.at(from, to));
+            if (u > utility) {
+                utility = u;
+                penalized.clear();
+            }
+            if (u == utility) {
+                penalized.push_back(from);
+            }
+        }
+
+        if (value < best) {
+            best = value;
+            best_path = t.to_path(static_cast<uint32_t>(starting_path[0]));
+
+            auto instance = prd_printer::instance();
+            if (instance) {
+                instance->print(iteration, static_cast<config::value_type>(best));
+            }
+            return lower_bound::should_stop(static_cast<config::value_type>(best));
+        }
+
+        return false;
+    };
+
+    inspect(0);
+
+    const auto started = std::chrono::steady_clock::now();
+    for (uint64_t iteration {}; iteration < params.iterations_; ++iteration) {
+        if (params.time_limit_ != 0 && iteration % 64 == 0
+            && std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(params.time_limit_)) {
+            break;
+        }
+
+        for (auto from : penalized) {
+            const auto to = t.next(from);
+            ++penalties.at(from, to);
+            if (symmetric) {
+                ++penalties.at(to, from);
+            }
+            optimizer.push(from);
+            optimizer.push(to);
+        }
+
+        optimizer.run(t);
+
+        if (inspect(iteration)) {
+            break;
+        }
+    }
+
+    return best_path;
+}
+
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace tsp::solver {
+
+namespace detail {
+
+    /**
+     * @brief fragmenty trasy budowane z pojedynczych krawedzi (nieskierowanych)
+     * krawedz da sie dodac tylko miedzy koncami dwoch roznych fragmentow -- stopien <= 2 i union-find pilnuje zeby nie zamknac cyklu
+     */
+    class fragments {
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        std::vector<std::array<uint32_t, 2>> links_ {};
+        std::vector<uint32_t> parent_ {};
+
+        auto find(uint32_t city) -> uint32_t
+        {
+            while (parent_[city] != city) {
+                parent_[city] = parent_[parent_[city]]; // polowienie sciezki
+                city = parent_[city];
+            }
+            return city;
+        }
+
+        auto degree(uint32_t city) const -> std::size_t
+        {
+            return (links_[city][0] != none) + (links_[city][1] != none);
+        }
+
+        void attach(uint32_t city, uint32_t other)
+        {
+            links_[city][links_[city][0] == none ? 0 : 1] = other;
+        }
+
+    public:
+        explicit fragments(std::size_t size)
+            : links_(size, { none, none })
+            , parent_(size)
+        {
+            std::iota(parent_.begin(), parent_.end(), 0);
+        }
+
+        auto try_link(uint32_t a, uint32_t b) -> bool
+        {
+            if (a == b || degree(a) == 2 || degree(b) == 2) {
+                return false;
+            }
+
+            auto root_a = find(a);
+            auto root_b = find(b);
+            if (root_a == root_b) {
+                return false;
+            }
+
+            parent_[root_a] = root_b;
+            attach(a, b);
+            attach(b, a);
+            return true;
+        }
+
+        /**
+         * @brief skleja fragmenty w jedna sciezke: po dojsciu do konca fragmentu skacze do najblizszego wolnego konca innego fragmentu
+         *
+         * @param skip miasto pominiete (np hub w savings), none jezeli brak
+         * @return sciezka po wszystkich miastach poza skip, bez powtorzenia poczatku
+         */
+        auto to_path(const ds::heap_matrix<config::value_type>& matrix, uint32_t skip = none) const -> config::path_type
+        {
+            const auto size = links_.size();
+
+            std::vector<uint32_t> ends {};
+            for (uint32_t city {}; city < size; ++city) {
+                if (city != skip && degree(city) < 2) {
+                    ends.push_back(city);
+                }
+            }
+
+            std::vector<bool> visited(size);
+            config::path_type path {};
+            path.reserve(size + 1);
+
+            auto walk = [&](uint32_t from) {
+                uint32_t previous = none;
+                uint32_t current = from;
+                while (current != none) {
+                    path.push_back(current);
+                    visited[current] = true;
+
+                    auto next = links_[current][0] != previous ? links_[current][0] : links_[current][1];
+                    previous = current;
+                    current = next;
+                }
+                return previous;
+            };
+
+            if (ends.empty()) {
+                return path;
+            }
+
+            auto tail = walk(ends[0]);
+            while (path.size() + (skip != none) < size) {
+                std::size_t closest {};
+                auto closest_value = std::numeric_limits<config::value_type>::max();
+                for (std::size_t i {}; i < ends.size(); ++i) {
+                    if (!visited[ends[i]] && matrix.at(tail, ends[i]) < closest_value) {
+                        closest = i;
+                        closest_value = matrix.at(tail, ends[i]);
+                    }
+                }
+
+                tail = walk(ends[closest]);
+            }
+
+            return path;
+        }
+    };
+
+    struct weighted_edge {
+        config::value_type value_ {};
+        uint32_t from_ {};
+        uint32_t to_ {};
+
+        auto operator<(const weighted_edge& other) const -> bool
+        {
+            return value_ < other.value_ || (value_ == other.value_ && (from_ < other.from_ || (from_ == other.from_ && to_ < other.to_)));
+        }
+    };
+
+    /**
+     * @brief pary miast do rozpatrzenia: wszystkie i < j, albo (dla k > 0) tylko z list k najblizszych
+     * duplikaty z list kandydatow nie przeszkadzaja -- druga proba polaczenia i tak sie nie uda
+     */
+    template <typename Visit>
+    inline void for_each_candidate_pair(const ds::heap_matrix<config::value_type>& matrix, std::size_t k, Visit&& visit)
+    {
+        const auto size = matrix.size();
+        if (k == 0) {
+            for (uint32_t i {}; i < size; ++i) {
+                for (uint32_t j = i + 1; j < size; ++j) {
+                    visit(i, j);
+                }
+            }
+        } else {
+            neighbour_lists candidates { matrix, k };
+            for (uint32_t i {}; i < size; ++i) {
+                for (auto j : candidates.at(i)) {
+                    visit(std::min(i, j), std::max(i, j));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief greedy matching (multi-fragment): krawedzie rosnaco wg wagi, dodawana jezeli oba konce maja stopien < 2
+ * i nie zamyka cyklu. dla symetrycznego TSP
+ *
+ * @param k 0 -> wszystkie pary O(n^2 log n), inaczej tylko listy k najblizszych O(n k log n)
+ */
+inline auto greedy_edge(const ds::heap_matrix<config::value_type>& matrix, std::size_t k = 0) -> config::path_type
+{
+    if (matrix.size() < 2) {
+        return config::path_type(2 * matrix.size(), 0);
+    }
+
+    std::vector<detail::weighted_edge> edges {};
+    edges.reserve(k == 0 ? matrix.size() * (matrix.size() - 1) / 2 : matrix.size() * k);
+    detail::for_each_candidate_pair(matrix, k, [&](uint32_t i, uint32_t j) {
+        edges.push_back({ matrix.at(i, j), i, j });
+    });
+    std::sort(edges.begin(), edges.end());
+
+    detail::fragments tour { matrix.size() };
+    for (auto const& edge : edges) {
+        tour.try_link(edge.from_, edge.to_);
+    }
+
+    auto path = tour.to_path(matrix);
+    if (!path.empty()) {
+        path.push_back(path[0]);
+    }
+    return path;
+}
+
+/**
+ * @brief Clarke-Wright savings: hub to miasto o najmniejszej sumie odleglosci, trasy hub -> i -> hub sa laczone
+ * w kolejnosci malejacych oszczednosci s(i, j) = d(hub, i) + d(hub, j) - d(i, j). dla symetrycznego TSP
+ *
+ * @param k 0 -> wszystkie pary O(n^2 log n), inaczej tylko listy k najblizszych O(n k log n)
+ */
+inline auto savings(const ds::heap_matrix<config::value_type>& matrix, std::size_t k = 0) -> config::path_type
+{
+    using saving_type = std::make_signed_t<config::value_type>;
+
+    const auto size = matrix.size();
+    if (size < 3) {
+        return greedy_edge(matrix);
+    }
+
+    uint32_t hub {};
+    {
+        auto hub_sum = std::numeric_limits<config::value_type>::max();
+        for (uint32_t city {}; city < size; ++city) {
+            config::value_type sum {};
+            for (uint32_t other {}; other < size; ++other) {
+                sum += matrix.at(city, other);
+            }
+            if (sum < hub_sum) {
+                hub_sum = sum;
+                hub = city;
+            }
+        }
+    }
+
+    struct saving {
+        saving_type value_ {};
+        uint32_t from_ {};
+        uint32_t to_ {};
+
+        // malejaco wg oszczednosci
+        auto operator<(const saving& other) const -> bool
+        {
+            return value_ > other.value_ || (value_ == other.value_ && (from_ < other.from_ || (from_ == other.from_ && to_ < other.to_)));
+        }
+    };
+
+    std::vector<saving> savings_list {};
+    savings_list.reserve(k == 0 ? size * (size - 1) / 2 : size * k);
+    detail::for_each_candidate_pair(matrix, k, [&](uint32_t i, uint32_t j) {
+        if (i == hub || j == hub) {
+            return;
+        }
+
+        auto value = static_cast<saving_type>(matrix.at(hub, i) + matrix.at(j, hub)) - static_cast<saving_type>(matrix.at(i, j));
+        savings_list.push_back({ value, i, j });
+    });
+    std::sort(savings_list.begin(), savings_list.end());
+
+    detail::fragments routes { size };
+    for (auto const& s : savings_list) {
+        routes.try_link(s.from_, s.to_);
+    }
+
+    auto route = routes.to_path(matrix, hub);
+
+    config::path_type path {};
+    path.reserve(size + 1);
+    path.push_back(hub);
+    path.insert(path.end(), route.begin(), route.end());
+    path.push_back(hub);
+    return path;
+}
+
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tsp::solver::held_karp {
+
+// 2^23 * 24 wpisow po 4 + 1 bajt -- okolo 1GB, wiecej nie ma sensu
+constexpr std::size_t max_cities = 25;
+
+namespace detail {
+
+    /**
+     * @brief tablica DP w zwartym ukladzie: wpis (S, last) zawsze ma last w S, wiec bit last jest wycinany z maski
+     * i kazde last dostaje swoj blok 2^(m-1) -- polowa pamieci wzgledem [2^m][m]
+     */
+    template <typename Cost>
+    struct table {
+        std::size_t cities_ {}; // m -- miasta poza startem
+        std::vector<Cost> cost_ {};
+        std::vector<uint8_t> parent_ {};
+
+        explicit table(std::size_t cities)
+            : cities_ { cities }
+            , cost_(cities << (cities - 1), std::numeric_limits<Cost>::max())
+            , parent_(cities << (cities - 1), 0)
+        {
+        }
+
+        auto index(uint32_t mask, uint32_t last) const -> std::size_t
+        {
+            uint32_t low = mask & ((uint32_t { 1 } << last) - 1);
+            uint32_t high = (mask >> (last + 1)) << last;
+            return (std::size_t { last } << (cities_ - 1)) | low | high;
+        }
+    };
+
+    /**
+     * @brief kolejne podzbiory o tej samej liczbie bitow (Gosper)
+     */
+    inline auto next_combination(uint32_t mask) -> uint32_t
+    {
+        uint32_t lowest = mask & (~mask + 1);
+        uint32_t ripple = mask + lowest;
+        return (((ripple ^ mask) >> 2) / lowest) | ripple;
+    }
+
+    template <typename Cost>
+    auto solve(const ds::heap_matrix<config::value_type>& matrix, std::size_t threads) -> config::path_type
+    {
+        const auto size = matrix.size();
+        const auto start = static_cast<uint32_t>(size - 1);
+        const auto cities = static_cast<uint32_t>(size - 1);
+        const uint32_t full = (uint32_t { 1 } << cities) - 1;
+
+        table<Cost> dp { cities };
+        for (uint32_t city {}; city < cities; ++city) {
+            dp.cost_[dp.index(uint32_t { 1 } << city, city)] = static_cast<Cost>(matrix.at(start, city));
+            dp.parent_[dp.index(uint32_t { 1 } << city, city)] = static_cast<uint8_t>(start);
+        }
+
+        // warstwy wg liczby miast w podzbiorze -- wewnatrz warstwy podzbiory sa niezalezne
+        auto sweep = [&](uint32_t layer, std::size_t part, std::size_t parts) {
+            std::size_t counter {};
+            for (uint32_t mask = (uint32_t { 1 } << layer) - 1; mask <= full; mask = next_combination(mask)) {
+                if (counter++ % parts != part) {
+                    continue;
+                }
+
+                for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+                    const auto last = static_cast<uint32_t>(std::countr_zero(rest));
+                    const uint32_t previous = mask & ~(uint32_t { 1 } << last);
+
+                    Cost best = std::numeric_limits<Cost>::max();
+                    uint8_t best_parent {};
+                    for (uint32_t candidates = previous; candidates != 0; candidates &= candidates - 1) {
+                        const auto before = static_cast<uint32_t>(std::countr_zero(candidates));
+                        const Cost value = dp.cost_[dp.index(previous, before)] + static_cast<Cost>(matrix.at(before, last));
+                        if (value < best) {
+                            best = value;
+                            best_parent = static_cast<uint8_t>(before);
+                        }
+                    }
+
+                    const auto at = dp.index(mask, last);
+                    dp.cost_[at] = best;
+                    dp.parent_[at] = best_parent;
+                }
+
+                if (mask == full) {
+                    break; // next_combination z pelnej maski wyszedlby poza zakres
+                }
+            }
+        };
+
+        threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+        // dla malych instancji nie oplaca sie nawet tworzyc puli
+        threads = cities < 12 ? 1 : std::max<std::size_t>(1, threads);
+
+        if (threads == 1) {
+            for (uint32_t layer = 2; layer <= cities; ++layer) {
+                sweep(layer, 0, 1);
+            }
+        } else {
+            utils::thread_pool pool { threads };
+            for (uint32_t layer = 2; layer <= cities; ++layer) {
+                std::vector<std::future<void>> futures {};
+                futures.reserve(threads);
+                for (std::size_t part {}; part < threads; ++part) {
+                    futures.push_back(pool.queue([&sweep, layer, part, threads]() {
+                        sweep(layer, part, threads);
+                    }));
+                }
+                for (auto& future : futures) {
+                    future.wait();
+                }
+            }
+        }
+
+        Cost best = std::numeric_limits<Cost>::max();
+        uint32_t last {};
+        for (uint32_t city {}; city < cities; ++city) {
+            const Cost value = dp.cost_[dp.index(full, city)] + static_cast<Cost>(matrix.at(city, start));
+            if (value < best) {
+                best = value;
+                last = city;
+            }
+        }
+
+        // odtwarzanie od konca po wskaznikach rodzicow
+        config::path_type path(size + 1);
+        path[0] = start;
+        path[size] = start;
+        uint32_t mask = full;
+        for (std::size_t position = cities; position > 0; --position) {
+            path[position] = last;
+            const auto before = dp.parent_[dp.index(mask, last)];
+            mask &= ~(uint32_t { 1 } << last);
+            last = before;
+        }
+
+        return path;
+    }
+}
+
+/**
+ * @brief dokladne rozwiazanie programowaniem dynamicznym Held-Karp, O(2^n n^2) czasu i O(2^n n) pamieci
+ * podzbiory jednej wielkosci sa liczone rownolegle. koszty czesciowe sa 32-bitowe jezeli suma najdluzszych krawedzi sie miesci
+ *
+ * @param threads 0 -> wszystkie dostepne
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, std::size_t threads = 0) -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size > max_cities) {
+        throw std::runtime_error { "held_karp:: za duza instancja, maksymalnie " + std::to_string(max_cities) + " miast" };
+    }
+    if (size < 3) {
+        config::path_type path(size);
+        for (std::size_t i {}; i < size; ++i) {
+            path[i] = i;
+        }
+        if (size > 0) {
+            path.push_back(0);
+        }
+        return path;
+    }
+
+    config::value_type upper {};
+    for (std::size_t from {}; from < size; ++from) {
+        config::value_type longest {};
+        for (std::size_t to {}; to < size; ++to) {
+            longest = std::max(longest, matrix.at(from, to));
+        }
+        upper += longest;
+    }
+
+    if (upper < std::numeric_limits<uint32_t>::max()) {
+        return detail::solve<uint32_t>(matrix, threads);
+    }
+    return detail::solve<uint64_t>(matrix, threads);
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "local_search.hpp"
+#include "lower_bound.hpp"
+#include "matrix.hpp"
+#include "path.hpp"
+#include "solver/prdprinter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace tsp::solver::ils {
+
+struct parameters {
+    uint64_t iterations_ { 100000 }; // liczba kickow
+    uint64_t time_limit_ { 0 }; // milisekundy, 0 -> tylko limit iteracji
+    std::size_t neighbours_ { 10 }; // dlugosc list kandydatow
+    std::size_t kick_length_ { 50 }; // maksymalna dlugosc zamienianych segmentow
+};
+
+/**
+ * @brief double-bridge na dwoch sasiednich krotkich segmentach: A B C D -> A C B D
+ * zmienia trzy krawedzie na stykach i kosztuje O(|B| + |C|) zamiast przebudowy calej trasy
+ */
+template <typename Cost, typename Rng>
+auto double_bridge(local_search::tour& t, local_search::optimizer<Cost>& optimizer, Cost const& cost, std::size_t max_length, Rng& rng)
+    -> local_search::delta_type
+{
+    const auto n = t.size();
+    max_length = std::max<std::size_t>(1, std::min(max_length, (n - 2) / 2));
+
+    std::uniform_int_distribution<std::size_t> start_distr(0, n - 1);
+    std::uniform_int_distribution<std::size_t> length_distr(1, max_length);
+    const auto start = start_distr(rng);
+    const auto first_length = length_distr(rng);
+    const auto second_length = length_distr(rng);
+
+    const auto a = t.at(start);
+    const auto b_first = t.at(start + 1);
+    const auto b_last = t.at(start + first_length);
+    const auto c_first = t.at(start + first_length + 1);
+    const auto c_last = t.at(start + first_length + second_length);
+    const auto d = t.at(start + first_length + second_length + 1);
+
+    const auto delta = cost(a, c_first) + cost(c_last, b_first) + cost(b_last, d)
+        - cost(a, b_first) - cost(b_last, c_first) - cost(c_last, d);
+
+    t.swap_blocks((start + 1) % n, first_length, second_length);
+
+    for (auto city : { a, b_first, b_last, c_first, c_last, d }) {
+        optimizer.push(city);
+    }
+
+    return delta;
+}
+
+/**
+ * @brief iterated local search: local search z don't-look bits, potem w petli double-bridge, ponowna optymalizacja
+ * tylko wokol zmienionych krawedzi i akceptacja jezeli nie jest gorzej -- inaczej zmiany sa cofane z dziennika trasy
+ * 2-opt + Or-opt dla STSP, sam Or-opt dla ATSP
+ */
+inline auto solve(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& starting_path, const parameters& params = {})
+    -> config::path_type
+{
+    const auto size = matrix.size();
+    if (size < 8) {
+        return starting_path;
+    }
+
+    std::random_device dev {};
+    std::mt19937_64 rng { dev() };
+
+    const neighbour_lists neighbours { matrix, params.neighbours_ };
+    const local_search::matrix_cost cost { matrix };
+    local_search::optimizer optimizer { neighbours, cost, is_symmetric(matrix) };
+    local_search::tour t { starting_path };
+
+    optimizer.push_all(t);
+    auto current = static_cast<local_search::delta_type>(calculate_value(matrix, starting_path)) + optimizer.run(t);
+
+    auto best = current;
+    auto best_path = t.to_path(static_cast<uint32_t>(starting_path[0]));
+
+    const auto started = std::chrono::steady_clock::now();
+    for (uint64_t iteration {}; iteration < params.iterations_; ++iteration) {
+        if (params.time_limit_ != 0 && iteration % 64 == 0
+            && std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(params.time_limit_)) {
+            break;
+        }
+
+        t.begin_trial();
+        auto delta = double_bridge(t, optimizer, cost, params.kick_length_, rng);
+        delta += optimizer.run(t);
+
+        if (delta > 0) {
+            t.rollback();
+            continue;
+        }
+
+        t.commit();
+        current += delta;
+        if (current < best) {
+            best = current;
+            best_path = t.to_path(static_cast<uint32_t>(starting_path[0]));
+
+            auto instance = prd_printer::instance();
+            if (instance) {
+                instance->print(iteration, static_cast<config::value_type>(best));
+            }
+            if (lower_bound::should_stop(static_cast<config::value_type>(best))) {
+                break;
+            }
+        }
+    }
+
+    return best_path;
+}
+
+}
@@ -0,0 +1,407 @@
+#pragma once
+
+#include "candidates.hpp"
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tsp::solver::local_search {
+
+using delta_type = int64_t;
+
+/**
+ * @brief trasa jako tablica miast + pozycje miast, cykliczna (bez powtorzonego miasta na koncu)
+ * wszystkie zmiany ida przez write(), wiec w trakcie proby mozna je zapisywac w dzienniku i tanio cofnac
+ */
+class tour {
+    std::vector<uint32_t> order_ {};
+    std::vector<uint32_t> position_ {};
+
+    bool journaling_ {};
+    std::vector<std::pair<uint32_t, uint32_t>> journal_ {}; // (pozycja, poprzednie miasto)
+    std::vector<uint32_t> buffer_ {};
+
+    void write(std::size_t index, uint32_t city)
+    {
+        if (journaling_) {
+            journal_.emplace_back(static_cast<uint32_t>(index), order_[index]);
+        }
+        order_[index] = city;
+        position_[city] = static_cast<uint32_t>(index);
+    }
+
+public:
+    explicit tour(const config::path_type& path)
+        : order_(path.begin(), path.end() - 1)
+        , position_(order_.size())
+    {
+        for (std::size_t i {}; i < order_.size(); ++i) {
+            position_[order_[i]] = static_cast<uint32_t>(i);
+        }
+    }
+
+    /**
+     * @brief nowa trasa tej samej dlugosci bez allokacji (np kolejne dziecko w genetycznym)
+     */
+    void assign(std::span<const uint32_t> cities)
+    {
+        order_.assign(cities.begin(), cities.end());
+        position_.resize(order_.size());
+        for (std::size_t i {}; i < order_.size(); ++i) {
+            position_[order_[i]] = static_cast<uint32_t>(i);
+        }
+        journaling_ = false;
+        journal_.clear();
+    }
+
+    auto size() const -> std::size_t
+    {
+        return order_.size();
+    }
+
+    auto at(std::size_t index) const -> uint32_t
+    {
+        return order_[index % order_.size()];
+    }
+
+    auto position(uint32_t city) const -> std::size_t
+    {
+        return position_[city];
+    }
+
+    auto next(uint32_t city) const -> uint32_t
+    {
+        auto index = position_[city] + 1;
+        return order_[index == order_.size() ? 0 : index];
+    }
+
+    auto prev(uint32_t city) const -> uint32_t
+    {
+        auto index = position_[city];
+        return order_[index == 0 ? order_.size() - 1 : index - 1];
+    }
+
+    /**
+     * @brief ile pozycji od from do to idac do przodu
+     */
+    auto distance(uint32_t from, uint32_t to) const -> std::size_t
+    {
+        return (position_[to] + order_.size() - position_[from]) % order_.size();
+    }
+
+    /**
+     * @brief odwraca fragment od pozycji from do to (cyklicznie, wlacznie)
+     * dla symetrycznych kosztow odwrocenie reszty trasy daje ten sam cykl, wiec odwracana jest krotsza strona
+     */
+    void reverse(std::size_t from, std::size_t to, bool symmetric = true)
+    {
+        const auto n = order_.size();
+        auto length = (to + n - from) % n + 1;
+        if (symmetric && 2 * length > n) {
+            std::swap(from, to);
+            from = (from + 1) % n;
+            to = (to + n - 1) % n;
+            length = n - length;
+        }
+
+        for (std::size_t i {}; i < length / 2; ++i) {
+            auto l = (from + i) % n;
+            auto r = (to + n - i) % n;
+            auto city = order_[l];
+            write(l, order_[r]);
+            write(r, city);
+        }
+    }
+
+    /**
+     * @brief [X Y] -> [Y X] dla sasiednich blokow zaczynajacych sie od pozycji start, O(|X| + |Y|)
+     */
+    void swap_blocks(std::size_t start, std::size_t first_length, std::size_t second_length)
+    {
+        const auto n = order_.size();
+        const auto length = first_length + second_length;
+
+        buffer_.resize(length);
+        for (std::size_t i {}; i < length; ++i) {
+            buffer_[i] = order_[(start + i) % n];
+        }
+        std::rotate(buffer_.begin(), buffer_.begin() + first_length, buffer_.end());
+        for (std::size_t i {}; i < length; ++i) {
+            write((start + i) % n, buffer_[i]);
+        }
+    }
+
+    void exchange(std::size_t i, std::size_t j)
+    {
+        auto city = order_[i];
+        write(i, order_[j]);
+        write(j, city);
+    }
+
+    /**
+     * @brief przenosi segment length miast od first miedzy after i next(after), bez odwracania
+     * after nie moze lezec w segmencie ani byc tuz przed nim. przesuwana jest krotsza strona trasy
+     */
+    void move_segment(uint32_t first, std::size_t length, uint32_t after)
+    {
+        const auto n = order_.size();
+        // [segment q..after] -> [q..after segment]  albo  [e..p segment] -> [segment e..p]
+        const auto ahead = (position_[after] + n - position_[first] - length) % n + 1;
+        const auto behind = n - length - ahead;
+        if (ahead <= behind) {
+            swap_blocks(position_[first], length, ahead);
+        } else {
+            swap_blocks((position_[after] + 1) % n, behind, length);
+        }
+    }
+
+    /**
+     * @brief od teraz zmiany sa zapisywane, commit() je zatwierdza, rollback() cofa -- oba O(liczby zmian)
+     */
+    void begin_trial()
+    {
+        journal_.clear();
+        journaling_ = true;
+    }
+
+    void commit()
+    {
+        journaling_ = false;
+        journal_.clear();
+    }
+
+    void rollback()
+    {
+        journaling_ = false;
+        for (auto it = journal_.rbegin(); it != journal_.rend(); ++it) {
+            order_[it->first] = it->second;
+            position_[it->second] = it->first;
+        }
+        journal_.clear();
+    }
+
+    /**
+     * @brief zamknieta trasa zaczynajaca sie od miasta start
+     */
+    auto to_path(uint32_t start = 0) const -> config::path_type
+    {
+        config::path_type path {};
+        path.reserve(order_.size() + 1);
+        for (std::size_t i {}; i < order_.size(); ++i) {
+            path.push_back(at(position_[start] + i));
+        }
+        path.push_back(start);
+
+        return path;
+    }
+};
+
+/**
+ * @brief koszt krawedzi prosto z macierzy -- GLS podstawia tu koszt z karami
+ */
+struct matrix_cost {
+    const ds::heap_matrix<config::value_type>& matrix_;
+
+    auto operator()(uint32_t from, uint32_t to) const -> delta_type
+    {
+        return static_cast<delta_type>(matrix_.at(from, to));
+    }
+};
+
+/**
+ * @brief 2-opt (tylko symetryczne) i Or-opt (segmenty 1-3 miast) po listach kandydatow z don't-look bits
+ * sprawdzane sa tylko miasta z kolejki -- po ulepszeniu trafiaja do niej konce zmienionych krawedzi,
+ * wiec po malej zmianie trasy (kick, kara) praca jest lokalna zamiast O(n^2) przegladu calej trasy
+ */
+template <typename Cost>
+class optimizer {
+    const neighbour_lists& neighbours_;
+    Cost cost_;
+    bool symmetric_;
+
+    // kolejka cykliczna -- kazde miasto jest w niej najwyzej raz (queued_), wiec n miejsc wystarczy i nic nie allokuje
+    std::vector<uint32_t> queue_ {};
+    std::size_t head_ {};
+    std::size_t queue_size_ {};
+    std::vector<uint8_t> queued_ {};
+
+    auto two_opt(tour& t, uint32_t a) -> delta_type
+    {
+        for (bool forward : { true, false }) {
+            const auto b = forward ? t.next(a) : t.prev(a);
+            const auto removed = forward ? cost_(a, b) : cost_(b, a);
+
+            for (auto c : neighbours_.at(a)) {
+                const auto added = cost_(a, c);
+                if (added >= removed) {
+                    break;
+                }
+
+                const auto d = forward ? t.next(c) : t.prev(c);
+                if (c == b || d == a) {
+                    continue;
+                }
+
+                const auto delta = added + cost_(b, d) - removed - cost_(c, d);
+                if (delta < 0) {
+                    // a b ... c d -> a c ... b d  albo  d c ... b a -> d b ... c a
+                    if (forward) {
+                        t.reverse(t.position(b), t.position(c));
+                    } else {
+                        t.reverse(t.position(a), t.position(d));
+                    }
+                    push(a), push(b), push(c), push(d);
+                    return delta;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    auto or_opt(tour& t, uint32_t first) -> delta_type
+    {
+        const auto n = t.size();
+
+        uint32_t last = first;
+        for (std::size_t length = 1; length <= 3 && length + 3 <= n; ++length, last = t.next(last)) {
+            const auto p = t.prev(first);
+            const auto q = t.next(last);
+            const auto removed = cost_(p, first) + cost_(last, q) - cost_(p, q);
+            if (removed <= 0) {
+                continue;
+            }
+
+            auto inside = [&](uint32_t city) {
+                return t.distance(first, city) < length;
+            };
+
+            // wstawienie miedzy c i e = next(c): c first .. last e, a dla symetrycznych tez c last .. first e
+            for (bool reversed : { false, true }) {
+                if (reversed && !symmetric_) {
+                    break;
+                }
+
+                const auto end = reversed ? first : last;
+                const auto begin = reversed ? last : first;
+                for (auto e : neighbours_.at(end)) {
+                    const auto added_end = cost_(end, e);
+                    if (added_end >= removed) {
+                        break;
+                    }
+
+                    const auto c = t.prev(e);
+                    if (inside(e) || inside(c)) {
+                        continue;
+                    }
+
+                    const auto delta = cost_(c, begin) + added_end - cost_(c, e) - removed;
+                    if (delta >= 0) {
+                        continue;
+                    }
+
+                    t.move_segment(first, length, c);
+                    if (reversed) {
+                        t.reverse(t.position(first), t.position(last));
+                    }
+
+                    push(p), push(q), push(c), push(e), push(first), push(last);
+                    return delta;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    auto pop() -> uint32_t
+    {
+        --queue_size_;
+        const auto city = queue_[head_];
+        head_ = head_ + 1 == queue_.size() ? 0 : head_ + 1;
+        return city;
+    }
+
+public:
+    optimizer(const neighbour_lists& neighbours, Cost cost, bool symmetric)
+        : neighbours_ { neighbours }
+        , cost_ { cost }
+        , symmetric_ { symmetric }
+        , queue_(neighbours.size())
+        , queued_(neighbours.size(), 0)
+    {
+    }
+
+    auto cost() -> Cost&
+    {
+        return cost_;
+    }
+
+    /**
+     * @brief zapala bit miasta -- zostanie sprawdzone przy nastepnym run()
+     */
+    void push(uint32_t city)
+    {
+        if (!queued_[city]) {
+            queued_[city] = 1;
+            auto tail = head_ + queue_size_++;
+            queue_[tail < queue_.size() ? tail : tail - queue_.size()] = city;
+        }
+    }
+
+    void push_all(const tour& t)
+    {
+        for (std::size_t i {}; i < t.size(); ++i) {
+            push(t.at(i));
+        }
+    }
+
+    /**
+     * @brief gasi wszystkie bity -- kolejka pusta
+     */
+    void clear()
+    {
+        while (queue_size_ > 0) {
+            queued_[pop()] = 0;
+        }
+    }
+
+    /**
+     * @brief ulepsza az kolejka bedzie pusta albo skonczy sie limit ruchow -- wtedy reszta kolejki jest porzucana
+     *
+     * @return laczna zmiana kosztu (<= 0)
+     */
+    auto run(tour& t, std::size_t max_moves = std::numeric_limits<std::size_t>::max()) -> delta_type
+    {
+        delta_type total {};
+        std::size_t moves {};
+        while (queue_size_ > 0) {
+            const auto city = pop();
+            queued_[city] = 0;
+
+            delta_type delta = symmetric_ ? two_opt(t, city) : 0;
+            if (delta == 0) {
+                delta = or_opt(t, city);
+            }
+            if (delta != 0) {
+                total += delta;
+                push(city);
+                if (++moves == max_moves) {
+                    clear();
+                    break;
+                }
+            }
+        }
+
+        return total;
+    }
+};
+
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "assignment.hpp"
+#include "config.hpp"
+#include "matrix.hpp"
+#include "one_tree.hpp"
+#include "path.hpp"
+#include "solver.hpp"
+#include "utils/atomic_min.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace tsp::solver::lower_bound {
+
+// powyzej tylu miast przydzial O(n^3) liczylby sie dluzej niz sam solver -- zostaje ograniczenie z minimow
+constexpr std::size_t max_assignment_cities = 2000;
+
+/**
+ * @brief najprostsze ograniczenie: kazde miasto musi z czegos wyjsc i do czegos wejsc -- max z sum minimow wierszy i kolumn
+ */
+inline auto row_column_minimums(const ds::heap_matrix<config::value_type>& matrix) -> config::value_type
+{
+    const auto size = matrix.size();
+
+    config::value_type rows {}, columns {};
+    for (std::size_t a {}; a < size; ++a) {
+        auto row = std::numeric_limits<config::value_type>::max();
+        auto column = std::numeric_limits<config::value_type>::max();
+        for (std::size_t b {}; b < size; ++b) {
+            if (a != b) {
+                row = std::min(row, matrix.at(a, b));
+                column = std::min(column, matrix.at(b, a));
+            }
+        }
+        rows += row;
+        columns += column;
+    }
+
+    return std::max(rows, columns);
+}
+
+/**
+ * @brief liczy dolne ograniczenie w osobnym threadzie, rownolegle z glownym solverem
+ * STSP -- Held-Karp (subgradient na 1-drzewach), ATSP -- problem przydzialu. najlepsza dotad wartosc jest
+ * publikowana atomowo, wiec solvery moga sprawdzac luke do swojej najlepszej trasy w trakcie pracy
+ *
+ * jak prd_printer -- jedna instancja na program, dostepna przez instance(). epsilon < 0 -> tylko raportowanie luki
+ */
+class engine {
+    inline static engine* s_instance = nullptr;
+
+    const ds::heap_matrix<config::value_type>& matrix_;
+    double epsilon_ {};
+
+    std::atomic<config::value_type> value_ { 0 };
+    std::atomic<bool> stop_ { false };
+    std::thread worker_ {};
+
+    void publish(double bound)
+    {
+        // koszty sa calkowite, wiec ograniczenie mozna zaokraglic w gore
+        if (bound > 0.) {
+            utils::atomic_fetch_max(value_, static_cast<config::value_type>(std::ceil(bound - 1e-6)));
+        }
+    }
+
+    void run()
+    {
+        const auto size = matrix_.size();
+        if (size < 2) {
+            return;
+        }
+
+        publish(static_cast<double>(row_column_minimums(matrix_)));
+
+        if (is_symmetric(matrix_)) {
+            if (size < 3) {
+                return;
+            }
+
+            auto upper = calculate_value(matrix_, nearest(matrix_, 0));
+
+            // przerwanie dopiero po kilku iteracjach (okolo 2 * 10^8 operacji), zeby szybkie solvery tez dostaly
+            // sensowne ograniczenie, a nie samo 1-drzewo bez kar
+            const std::size_t minimum_iterations = std::clamp<std::size_t>(200'000'000 / (size * size), 1, 1000);
+            std::size_t iteration {};
+            auto bound = one_tree::held_karp_bound(matrix_, upper, std::numeric_limits<std::size_t>::max(), [&](double best) {
+                publish(best);
+                return iteration++ >= minimum_iterations && stop_.load(std::memory_order_relaxed);
+            });
+            publish(bound.value_);
+        } else if (size <= max_assignment_cities) {
+            publish(static_cast<double>(assignment::solve(matrix_).value_));
+        }
+    }
+
+public:
+    engine(const ds::heap_matrix<config::value_type>& matrix, double epsilon)
+        : matrix_ { matrix }
+        , epsilon_ { epsilon }
+    {
+        s_instance = this;
+        worker_ = std::thread { [this]() { run(); } };
+    }
+
+    engine(const engine&) = delete;
+    auto operator=(const engine&) -> engine& = delete;
+
+    ~engine()
+    {
+        finish();
+        s_instance = nullptr;
+    }
+
+    static engine* instance()
+    {
+        return s_instance;
+    }
+
+    /**
+     * @brief konczy liczenie i czeka na thread -- potem value() juz sie nie zmieni
+     */
+    void finish()
+    {
+        stop_ = true;
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    auto value() const -> config::value_type
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief luka w procentach jak PRD, tylko wzgledem dolnego ograniczenia -- optimum lezy miedzy nimi
+     */
+    auto gap(config::value_type value) const -> double
+    {
+        auto bound = this->value();
+        if (bound == 0) {
+            return value == 0 ? 0. : std::numeric_limits<double>::infinity();
+        }
+
+        return calculate_prd(value, bound);
+    }
+
+    auto reached(config::value_type value) const -> bool
+    {
+        return epsilon_ >= 0. && gap(value) <= epsilon_;
+    }
+};
+
+/**
+ * @brief dla solverow: czy trasa o tej wartosci jest juz dosc blisko ograniczenia, zeby przerwac
+ */
+inline auto should_stop(config::value_type value) -> bool
+{
+    auto instance = engine::instance();
+    return instance && instance->reached(value);
+}
+
+}
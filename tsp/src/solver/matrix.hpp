@@ -98,6 +98,14 @@ public:
         return size_;
     }
 
+    /**
+     * @brief surowa pamiec size * size wierszami y -- do petli po calej macierzy naraz
+     */
+    auto data() const -> ValueType*
+    {
+        return mem_;
+    }
+
     /**
      * @brief referencja miejsca w macierzy x rosnie w prawo y w dol
      *
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tsp::solver::one_tree {
+
+/**
+ * @brief minimalne 1-drzewo z karami pi: MST na miastach poza special + dwie najtansze krawedzie ze special
+ * koszt krawedzi to d(i, j) + pi[i] + pi[j]. dla symetrycznego TSP
+ *
+ * @param degree wyjscie -- stopnie miast w 1-drzewie
+ * @return koszt 1-drzewa z karami (bez odejmowania 2 * suma pi)
+ */
+inline auto minimum(
+    const ds::heap_matrix<config::value_type>& matrix,
+    const std::vector<double>& pi,
+    std::vector<uint32_t>& degree,
+    std::size_t special = 0)
+    -> double
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    const auto size = matrix.size();
+
+    degree.assign(size, 0);
+    if (size < 3) {
+        return 0.;
+    }
+
+    auto cost = [&](std::size_t i, std::size_t j) {
+        return static_cast<double>(matrix.at(i, j)) + pi[i] + pi[j];
+    };
+
+    std::vector<double> key(size, infinity);
+    std::vector<uint32_t> parent(size, 0);
+    std::vector<uint8_t> in_tree(size, 0);
+    in_tree[special] = 1;
+
+    std::size_t root = special == 0 ? 1 : 0;
+    in_tree[root] = 1;
+    std::size_t added = root;
+
+    double total {};
+    for (std::size_t step = 2; step < size; ++step) {
+        std::size_t closest = size;
+        for (std::size_t city {}; city < size; ++city) {
+            if (in_tree[city]) {
+                continue;
+            }
+
+            auto value = cost(added, city);
+            if (value < key[city]) {
+                key[city] = value;
+                parent[city] = static_cast<uint32_t>(added);
+            }
+            if (closest == size || key[city] < key[closest]) {
+                closest = city;
+            }
+        }
+
+        in_tree[closest] = 1;
+        total += key[closest];
+        ++degree[closest];
+        ++degree[parent[closest]];
+        added = closest;
+    }
+
+    // dwie najtansze krawedzie ze special
+    double first = infinity, second = infinity;
+    std::size_t first_city {}, second_city {};
+    for (std::size_t city {}; city < size; ++city) {
+        if (city == special) {
+            continue;
+        }
+
+        auto value = cost(special, city);
+        if (value < first) {
+            second = first;
+            second_city = first_city;
+            first = value;
+            first_city = city;
+        } else if (value < second) {
+            second = value;
+            second_city = city;
+        }
+    }
+    total += first + second;
+    degree[special] += 2;
+    ++degree[first_city];
+    ++degree[second_city];
+
+    return total;
+}
+
+struct bound {
+    double value_ {};
+    std::vector<double> pi_ {};
+};
+
+/**
+ * @brief dolne ograniczenie Held-Karpa: maksymalizacja po pi wartosci L(pi) = 1-drzewo(pi) - 2 * suma pi
+ * metoda subgradientowa (Held, Wolfe, Crowder) -- pi rosnie dla miast o stopniu > 2, maleje dla lisci
+ *
+ * @param upper znana gorna granica (np dlugosc dowolnej trasy), steruje dlugoscia kroku
+ * @param should_stop wolane co iteracje z najlepsza dotad wartoscia (-inf przed pierwsza), pozwala ja publikowac i przerwac z zewnatrz
+ */
+template <typename ShouldStop>
+inline auto held_karp_bound(
+    const ds::heap_matrix<config::value_type>& matrix,
+    config::value_type upper,
+    std::size_t iterations,
+    ShouldStop const& should_stop)
+    -> bound
+{
+    const auto size = matrix.size();
+
+    bound best { -std::numeric_limits<double>::infinity(), std::vector<double>(size, 0.) };
+    std::vector<double> pi(size, 0.);
+    std::vector<uint32_t> degree {};
+
+    double step_factor = 2.;
+    std::size_t since_improvement {};
+    const std::size_t patience = std::max<std::size_t>(10, size / 2);
+
+    for (std::size_t iteration {}; iteration < iterations && !should_stop(best.value_); ++iteration) {
+        double value = minimum(matrix, pi, degree);
+        double pi_sum {};
+        for (auto p : pi) {
+            pi_sum += p;
+        }
+        value -= 2. * pi_sum;
+
+        if (value > best.value_ + 1e-9) {
+            best.value_ = value;
+            best.pi_ = pi;
+            since_improvement = 0;
+        } else if (++since_improvement >= patience) {
+            step_factor /= 2.;
+            since_improvement = 0;
+        }
+
+        double norm {};
+        for (auto d : degree) {
+            norm += (double(d) - 2.) * (double(d) - 2.);
+        }
+        // 1-drzewo jest trasa -- lepiej sie nie da
+        if (norm == 0. || step_factor < 1e-6) {
+            break;
+        }
+
+        double step = step_factor * (double(upper) - value) / norm;
+        for (std::size_t city {}; city < size; ++city) {
+            pi[city] += step * (double(degree[city]) - 2.);
+        }
+    }
+
+    return best;
+}
+
+inline auto held_karp_bound(const ds::heap_matrix<config::value_type>& matrix, config::value_type upper, std::size_t iterations) -> bound
+{
+    return held_karp_bound(matrix, upper, iterations, [](double) { return false; });
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "assignment.hpp"
+#include "config.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tsp::solver {
+
+/**
+ * @brief Karp patching dla ATSP: rozwiazanie problemu przydzialu (cykle pokrywajace wszystkie miasta),
+ * a potem doklejanie kolejnych cykli (od najwiekszych) do glownego przez najtansza zamiane dwoch nastepnikow
+ * i -> s(i), j -> s(j) na i -> s(j), j -> s(i). przydzial O(n^3), latanie O(n^2)
+ */
+inline auto karp_patching(const ds::heap_matrix<config::value_type>& matrix) -> config::path_type
+{
+    using assignment::cost_type;
+
+    const auto size = matrix.size();
+    if (size < 2) {
+        return config::path_type(2 * size, 0);
+    }
+
+    auto successor = assignment::solve(matrix).successor_;
+
+    std::vector<std::vector<uint32_t>> cycles {};
+    {
+        std::vector<uint8_t> seen(size, 0);
+        for (uint32_t city {}; city < size; ++city) {
+            if (seen[city]) {
+                continue;
+            }
+
+            auto& cycle = cycles.emplace_back();
+            for (auto c = city; !seen[c]; c = successor[c]) {
+                seen[c] = 1;
+                cycle.push_back(c);
+            }
+        }
+    }
+    std::stable_sort(cycles.begin(), cycles.end(), [](const auto& l, const auto& r) {
+        return l.size() > r.size();
+    });
+
+    auto cost = [&matrix](uint32_t from, uint32_t to) {
+        return static_cast<cost_type>(matrix.at(from, to));
+    };
+
+    std::vector<uint32_t> main_cycle = std::move(cycles[0]);
+    for (std::size_t c = 1; c < cycles.size(); ++c) {
+        auto const& cycle = cycles[c];
+
+        cost_type best_delta = std::numeric_limits<cost_type>::max();
+        uint32_t best_i {}, best_j {};
+        for (auto i : main_cycle) {
+            const auto si = successor[i];
+            const auto removed_i = cost(i, si);
+            for (auto j : cycle) {
+                const auto sj = successor[j];
+                auto delta = cost(i, sj) + cost(j, si) - removed_i - cost(j, sj);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+
+        std::swap(successor[best_i], successor[best_j]);
+        main_cycle.insert(main_cycle.end(), cycle.begin(), cycle.end());
+    }
+
+    config::path_type path {};
+    path.reserve(size + 1);
+    uint32_t city {};
+    for (std::size_t step {}; step < size; ++step) {
+        path.push_back(city);
+        city = successor[city];
+    }
+    path.push_back(path[0]);
+
+    return path;
+}
+
+}
@@ -84,6 +84,22 @@ inline auto calculate_prd(const config::value_type& value, const config::value_t
     return 0.;
 }
 
+/**
+ * @brief czy macierz jest symetryczna -- czesc algorytmow (1-drzewa, odwracanie fragmentow w O(1)) dziala tylko dla STSP
+ */
+inline auto is_symmetric(const ds::heap_matrix<config::value_type>& matrix) -> bool
+{
+    for (std::size_t y {}; y < matrix.size(); ++y) {
+        for (std::size_t x {}; x < y; ++x) {
+            if (matrix.at(x, y) != matrix.at(y, x)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 inline void assert_path(const config::path_type& path)
 {
     std::vector<uint16_t> v(path.size());
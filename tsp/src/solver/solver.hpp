@@ -1,16 +1,24 @@
+#pragma once
+
 #include "matrix.hpp"
 #include "path.hpp"
 #include "surroundings.hpp"
 #include "config.hpp"
 
+#include "utils/atomic_min.hpp"
+#include "utils/thread_pool.hpp"
+
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <optional>
 #include <random>
-#include <set>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -63,37 +71,172 @@ inline auto monotonic(const ds::heap_matrix<config::value_type>& matrix) -> std:
     return example_path::monotonic(matrix);
 }
 
-inline auto k_random(const ds::heap_matrix<config::value_type>& matrix, uint64_t k) -> std::vector<std::size_t>
+/**
+ * @brief najlepsza z k losowych permutacji
+ *
+ * k jest dzielone miedzy thready, kazdy ma wlasny generator i wlasny bufor ktory tasuje w miejscu
+ * (permutacja po przetasowaniu dalej jest permutacja, wiec nie trzeba jej odtwarzac). sumowanie trasy
+ * jest przerywane jak tylko prefiks dorowna najlepszemu dotychczasowemu kosztowi (wspolny atomic)
+ */
+inline auto k_random(const ds::heap_matrix<config::value_type>& matrix, uint64_t k, std::size_t threads = 0) -> std::vector<std::size_t>
 {
-    std::random_device device;
-    std::mt19937 twister(device());
+    const auto size = matrix.size();
+
+    threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    threads = std::max<std::size_t>(1, std::min<uint64_t>(threads, k));
+
+    std::atomic<config::value_type> incumbent { std::numeric_limits<config::value_type>::max() };
 
-    std::vector<std::size_t> indices {};
-    indices.reserve(matrix.size() + 1);
+    std::vector<std::optional<config::value_type>> thread_best_value(threads);
+    std::vector<std::vector<std::size_t>> thread_best(threads);
 
-    for (std::size_t i {}; i < matrix.size(); ++i) {
-        indices.push_back(i);
+    std::random_device device;
+    std::vector<std::mt19937::result_type> seeds(threads);
+    for (auto& seed : seeds) {
+        seed = device();
     }
 
-    decltype(indices) best {};
-    std::optional<config::value_type> best_value {};
-    for (std::size_t i {}; i < k; ++i) {
-        auto path { indices }; // alokacja kopia i move vs 1 kopia i potencjalnie druga kopia -- tak chyba lepiej ??
+    auto worker = [&](std::size_t thread) {
+        std::mt19937 twister(seeds[thread]);
+
+        std::vector<std::size_t> path(size);
+        std::iota(path.begin(), path.end(), 0);
+
+        auto& best = thread_best[thread];
+        auto& best_value = thread_best_value[thread];
+        best.reserve(size + 1);
+
+        uint64_t samples = k / threads + (thread < k % threads ? 1 : 0);
+        for (uint64_t sample {}; sample < samples; ++sample) {
+            std::shuffle(path.begin(), path.end(), twister);
+
+            const auto bound = incumbent.load(std::memory_order_relaxed);
+            config::value_type value {};
+            bool aborted = false;
+            for (std::size_t i = 1; i < size; ++i) {
+                value += matrix.at(path[i - 1], path[i]);
+                if (value >= bound) {
+                    aborted = true;
+                    break;
+                }
+            }
+            if (!aborted) {
+                value += matrix.at(path[size - 1], path[0]);
+                aborted = value >= bound;
+            }
 
-        std::shuffle(path.begin(), path.end(), twister);
-        path.push_back(path[0]);
+            // thread moze nie miec zadnej wlasnej trasy -- wtedy lepsza ma inny, ten od incumbenta
+            if (!aborted) {
+                best_value = value;
+                best.assign(path.begin(), path.end());
+                best.push_back(best[0]);
+
+                utils::atomic_fetch_min(incumbent, value);
+            }
+        }
+    };
+
+    if (threads == 1) {
+        worker(0);
+    } else {
+        utils::thread_pool pool { threads };
+        std::vector<std::future<void>> futures {};
+        futures.reserve(threads);
+        for (std::size_t thread {}; thread < threads; ++thread) {
+            futures.push_back(pool.queue([&worker, thread]() { worker(thread); }));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
 
-        auto value = calculate_value(matrix, path);
-        if ((best_value && value < *best_value) || !best_value) {
-            best_value = value;
-            best = std::move(path);
+    std::optional<std::size_t> best_thread {};
+    for (std::size_t thread {}; thread < threads; ++thread) {
+        if (thread_best_value[thread] && (!best_thread || *thread_best_value[thread] < *thread_best_value[*best_thread])) {
+            best_thread = thread;
         }
     }
 
-    if (!best_value) {
+    if (!best_thread) {
         throw std::runtime_error("nie znaleziono besta. nie chce mi sie pisac obslugi bledow");
     }
-    return best;
+    return std::move(thread_best[*best_thread]);
+}
+
+namespace detail {
+
+    /**
+     * @brief pamiec robocza nearest -- allokowana raz na cale przejscie, a nie w kazdym kroku
+     *
+     * unvisited_ to zwarta tablica nieodwiedzonych miast (usuwanie przez swap z ostatnim),
+     * slot_of_ to odwrotnosc -- na ktorym miejscu unvisited_ lezy dane miasto,
+     * costs_ to wiersz odleglosci do nieodwiedzonych zebrany w ciagla pamiec
+     */
+    struct nearest_workspace {
+        std::vector<std::size_t> unvisited_ {};
+        std::vector<std::size_t> slot_of_ {};
+        std::vector<config::value_type> costs_ {};
+        std::size_t unvisited_count_ {};
+
+        explicit nearest_workspace(std::size_t size)
+            : unvisited_(size)
+            , slot_of_(size)
+            , costs_(size)
+        {
+        }
+
+        void reset(std::size_t starting_position)
+        {
+            unvisited_count_ = unvisited_.size();
+            for (std::size_t i {}; i < unvisited_count_; ++i) {
+                unvisited_[i] = i;
+                slot_of_[i] = i;
+            }
+            remove(starting_position);
+        }
+
+        void remove(std::size_t city)
+        {
+            auto slot = slot_of_[city];
+            auto last = unvisited_[unvisited_count_ - 1];
+
+            unvisited_[slot] = last;
+            slot_of_[last] = slot;
+            --unvisited_count_;
+        }
+    };
+
+    /**
+     * @brief zamaskowany argmin po wierszu macierzy -- najblizsze nieodwiedzone miasto
+     * przy remisie wygrywa najmniejszy indeks miasta, tak jak w wersji ze std::set (tam szlismy rosnaco i bralismy pierwsze)
+     *
+     * obie petle to czyste redukcje bez rozgalezien, wiec kompilator je wektoryzuje
+     */
+    inline auto closest_unvisited(
+        const ds::heap_matrix<config::value_type>& matrix,
+        std::size_t position,
+        nearest_workspace& workspace)
+        -> std::size_t
+    {
+        const auto count = workspace.unvisited_count_;
+        const std::size_t* unvisited = workspace.unvisited_.data();
+        config::value_type* costs = workspace.costs_.data();
+
+        config::value_type closest_value = std::numeric_limits<config::value_type>::max();
+        for (std::size_t j {}; j < count; ++j) {
+            auto value = matrix.at(position, unvisited[j]);
+            costs[j] = value;
+            closest_value = std::min(closest_value, value);
+        }
+
+        std::size_t closest_position = std::numeric_limits<std::size_t>::max();
+        for (std::size_t j {}; j < count; ++j) {
+            auto candidate = costs[j] == closest_value ? unvisited[j] : std::numeric_limits<std::size_t>::max();
+            closest_position = std::min(closest_position, candidate);
+        }
+
+        return closest_position;
+    }
 }
 
 inline auto nearest(const ds::heap_matrix<config::value_type>& matrix, const std::size_t starting_position) -> std::vector<std::size_t>
@@ -105,28 +248,16 @@ inline auto nearest(const ds::heap_matrix<config::value_type>& matrix, const std
     std::vector<std::size_t> path {};
     path.reserve(matrix.size() + 1);
     path.push_back(starting_position);
-    std::set<std::size_t> already_visited {};
-    already_visited.insert(starting_position);
+
+    detail::nearest_workspace workspace { matrix.size() };
+    workspace.reset(starting_position);
 
     auto position = starting_position;
     for (size_t num { 1 }; num < matrix.size(); ++num) {
-        std::optional<config::value_type> closest_value {};
-        std::size_t closest_position {};
-        for (std::size_t i {}; i < matrix.size(); ++i) {
-            if (i == position || already_visited.find(i) != already_visited.end()) { // tak jest 3x szybciej dla p654
-                // if (i == position || std::find(path.begin(), path.end(), i) != path.end()) {
-                continue;
-            }
-
-            auto value = matrix.at(position, i);
-            if (!closest_value || (closest_value && value < *closest_value)) {
-                closest_value = value;
-                closest_position = i;
-            }
-        }
+        auto closest_position = detail::closest_unvisited(matrix, position, workspace);
 
         path.push_back(closest_position);
-        already_visited.insert(closest_position);
+        workspace.remove(closest_position);
         position = closest_position;
     }
 
@@ -135,22 +266,129 @@ inline auto nearest(const ds::heap_matrix<config::value_type>& matrix, const std
     return path;
 }
 
-inline auto nearest_ext(const ds::heap_matrix<config::value_type>& matrix) -> std::vector<std::size_t>
+namespace detail {
+
+    /**
+     * @brief koszt trasy nearest od starting_position (z powrotem do startu), bez budowania samej trasy
+     * przerywa i zwraca nullopt jak tylko czesciowy koszt przekroczy bound() -- bound jest pytany co krok,
+     * bo incumbent moze w tym czasie poprawic inny thread
+     */
+    template <typename Bound>
+    inline auto nearest_cost(
+        const ds::heap_matrix<config::value_type>& matrix,
+        std::size_t starting_position,
+        nearest_workspace& workspace,
+        Bound const& bound)
+        -> std::optional<config::value_type>
+    {
+        workspace.reset(starting_position);
+
+        config::value_type cost {};
+        auto position = starting_position;
+        for (size_t num { 1 }; num < matrix.size(); ++num) {
+            auto closest_position = closest_unvisited(matrix, position, workspace);
+
+            cost += matrix.at(position, closest_position);
+            if (cost > bound()) {
+                return {};
+            }
+
+            workspace.remove(closest_position);
+            position = closest_position;
+        }
+
+        cost += matrix.at(position, starting_position);
+        if (cost > bound()) {
+            return {};
+        }
+
+        return cost;
+    }
+}
+
+struct nearest_ext_parameters {
+    std::size_t threads_ { 0 }; // 0 -> wszystkie dostepne
+    std::size_t samples_ { 0 }; // 0 -> kazde miasto jest startem, inaczej tyle losowych startow
+};
+
+/**
+ * @brief nearest z kazdego (albo z samples_ losowych) miast startowych, zwraca najlepsza trase
+ *
+ * starty sa rozdzielane miedzy thready puli, najlepszy koszt jest wspolny (atomic) i kazde przejscie
+ * ktorego czesciowy koszt juz go przekracza jest porzucane. przy rownym koszcie wygrywa mniejszy indeks startu,
+ * wiec wynik jest taki sam jak w wersji sekwencyjnej
+ */
+inline auto nearest_ext(const ds::heap_matrix<config::value_type>& matrix, const nearest_ext_parameters& params = {}) -> std::vector<std::size_t>
 {
-    std::optional<config::value_type> best_value {};
-    std::vector<std::size_t> best_path {};
-    for (std::size_t i {}; i < matrix.size(); ++i) {
+    const auto size = matrix.size();
+    if (size == 0) {
+        return {};
+    }
+
+    std::vector<std::size_t> starts(size);
+    std::iota(starts.begin(), starts.end(), 0);
+    if (params.samples_ != 0 && params.samples_ < size) {
+        std::random_device device;
+        std::mt19937 twister(device());
+
+        std::shuffle(starts.begin(), starts.end(), twister);
+        starts.resize(params.samples_);
+    }
+
+    std::size_t threads = params.threads_ == 0 ? std::thread::hardware_concurrency() : params.threads_;
+    threads = std::max<std::size_t>(1, std::min(threads, starts.size()));
+
+    std::atomic<config::value_type> incumbent { std::numeric_limits<config::value_type>::max() };
+    std::atomic<std::size_t> next_start { 0 };
 
-        auto path = nearest(matrix, i);
-        auto value = calculate_value(matrix, path);
+    struct candidate {
+        config::value_type value_ { std::numeric_limits<config::value_type>::max() };
+        std::size_t start_ { std::numeric_limits<std::size_t>::max() };
+
+        auto operator<(const candidate& other) const -> bool
+        {
+            return value_ < other.value_ || (value_ == other.value_ && start_ < other.start_);
+        }
+    };
+    std::vector<candidate> thread_best(threads);
 
-        if (!best_value || (best_value && value < *best_value)) {
-            best_value = value;
-            best_path = std::move(path);
+    auto worker = [&](std::size_t thread) {
+        detail::nearest_workspace workspace { size };
+        auto bound = [&incumbent]() {
+            return incumbent.load(std::memory_order_relaxed);
+        };
+
+        for (auto i = next_start.fetch_add(1); i < starts.size(); i = next_start.fetch_add(1)) {
+            auto value = detail::nearest_cost(matrix, starts[i], workspace, bound);
+            if (!value) {
+                continue;
+            }
+
+            utils::atomic_fetch_min(incumbent, *value);
+
+            candidate found { *value, starts[i] };
+            if (found < thread_best[thread]) {
+                thread_best[thread] = found;
+            }
+        }
+    };
+
+    if (threads == 1) {
+        worker(0);
+    } else {
+        utils::thread_pool pool { threads };
+        std::vector<std::future<void>> futures {};
+        futures.reserve(threads);
+        for (std::size_t thread {}; thread < threads; ++thread) {
+            futures.push_back(pool.queue([&worker, thread]() { worker(thread); }));
+        }
+        for (auto& future : futures) {
+            future.wait();
         }
     }
 
-    return best_path;
+    auto best = *std::min_element(thread_best.begin(), thread_best.end());
+    return nearest(matrix, best.start_);
 }
 
 template <typename Surrounding>
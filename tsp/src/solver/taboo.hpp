@@ -1,5 +1,6 @@
 #pragma once
 
+#include "lower_bound.hpp"
 #include "path.hpp"
 #include "surroundings.hpp"
 #include "config.hpp"
@@ -157,6 +158,10 @@ struct solver {
                 if (*best_value < best_len) {
                     best_len = *best_value;
                     best = best_path;
+
+                    if (lower_bound::should_stop(best_len)) {
+                        return best;
+                    }
                 }
 
                 list.add(best_pair);
@@ -1,10 +1,22 @@
 #include "modules/demo.hpp"
 #include "modules/python_export.hpp"
 
+#include "solver/aco.hpp"
+#include "solver/annealing.hpp"
+#include "solver/balas_simonetti.hpp"
+#include "solver/branch_and_bound.hpp"
+#include "solver/christofides.hpp"
 #include "solver/genetic.hpp"
+#include "solver/gls.hpp"
+#include "solver/greedy.hpp"
+#include "solver/held_karp.hpp"
+#include "solver/ils.hpp"
+#include "solver/lower_bound.hpp"
 #include "solver/matrix.hpp"
+#include "solver/patching.hpp"
 #include "solver/path.hpp"
 #include "solver/solver.hpp"
+#include "solver/space_filling.hpp"
 #include "solver/surroundings.hpp"
 #include "solver/taboo.hpp"
 #include "tsp_data/parse_file.hpp"
@@ -25,6 +37,7 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <random>
@@ -73,6 +86,31 @@ auto initialize_matrix(const arguments& opts) -> ds::heap_matrix<T>
     }
 }
 
+auto load_coordinates(const arguments& opts) -> tsp_data::coordinates
+{
+    if (opts.problem_ != "file") {
+        throw std::runtime_error("load_coordinates:: wspolrzedne sa tylko dla problemu z pliku EUC_2D");
+    }
+
+    std::ifstream file { opts.problem_argument_.c_str() };
+    if (!file.is_open()) {
+        throw std::runtime_error("load_coordinates:: nie mozna otworzyc pliku!");
+    }
+
+    return tsp_data::parse_coordinates<config::value_type>(file);
+}
+
+auto construction_threads(const arguments& opts) -> std::size_t
+{
+    std::size_t threads { 0 };
+    if (!opts.construction_threads_.empty()) {
+        std::stringstream ss { opts.construction_threads_ };
+        ss >> threads;
+    }
+
+    return threads;
+}
+
 template <typename T>
 auto choose_primary_algorithm(const arguments& opts) -> std::function<std::vector<std::size_t>(ds::heap_matrix<T>)>
 {
@@ -89,7 +127,7 @@ auto choose_primary_algorithm(const arguments& opts) -> std::function<std::vecto
             }
         }
 
-        return std::bind(solver::k_random, _1, k);
+        return std::bind(solver::k_random, _1, k, construction_threads(opts));
 
     } else if (opts.algo_ == "nearest") {
 
@@ -107,8 +145,56 @@ auto choose_primary_algorithm(const arguments& opts) -> std::function<std::vecto
         return std::bind(solver::nearest, _1, position);
 
     } else if (opts.algo_ == "nearest_ext") {
-        return solver::nearest_ext;
-    } else if (opts.algo_ == "2_opt" || opts.algo_ == "2_opt_sym" || opts.algo_ == "2_opt_swap") {
+        solver::nearest_ext_parameters params {};
+
+        if (!opts.algo_option_.empty()) {
+            std::stringstream ss { opts.algo_option_ };
+            ss >> params.samples_;
+        }
+
+        params.threads_ = construction_threads(opts);
+
+        return std::bind(solver::nearest_ext, _1, params);
+    } else if (opts.algo_ == "greedy" || opts.algo_ == "savings") {
+
+        std::size_t k { 0 };
+        if (!opts.algo_option_.empty()) {
+            std::stringstream ss { opts.algo_option_ };
+            ss >> k;
+        }
+
+        if (opts.algo_ == "greedy") {
+            return std::bind(solver::greedy_edge, _1, k);
+        }
+        return std::bind(solver::savings, _1, k);
+
+    } else if (opts.algo_ == "christofides") {
+        return std::bind(solver::christofides, _1, construction_threads(opts));
+
+    } else if (opts.algo_ == "karp") {
+        return solver::karp_patching;
+
+    } else if (opts.algo_ == "held_karp") {
+        return std::bind(solver::held_karp::solve, _1, construction_threads(opts));
+
+    } else if (opts.algo_ == "branch_and_bound") {
+        solver::branch_and_bound::parameters params {};
+
+        if (!opts.algo_option_.empty()) {
+            std::stringstream ss { opts.algo_option_ };
+            ss >> params.time_limit_;
+        }
+        params.threads_ = construction_threads(opts);
+
+        return std::bind(solver::branch_and_bound::solve, _1, params);
+
+    } else if (opts.algo_ == "hilbert") {
+        // macierz jest ignorowana -- krzywa potrzebuje wspolrzednych
+        return [coords = load_coordinates(opts), threads = construction_threads(opts)](ds::heap_matrix<T> const&) -> std::vector<std::size_t> {
+            return solver::space_filling::hilbert(coords, threads);
+        };
+
+    } else if (opts.algo_ == "2_opt" || opts.algo_ == "2_opt_sym" || opts.algo_ == "2_opt_swap" || opts.algo_ == "balas_simonetti") {
 
         auto&& algorithm_option = opts.algo_option_;
         auto choose_starting_path = [algorithm_option](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
@@ -116,6 +202,14 @@ auto choose_primary_algorithm(const arguments& opts) -> std::function<std::vecto
                 return solver::example_path::monotonic(matrix);
             } else if (algorithm_option == "rand") {
                 return solver::example_path::random(matrix);
+            } else if (algorithm_option == "greedy") {
+                return solver::greedy_edge(matrix);
+            } else if (algorithm_option == "savings") {
+                return solver::savings(matrix);
+            } else if (algorithm_option == "christofides") {
+                return solver::christofides(matrix);
+            } else if (algorithm_option == "karp") {
+                return solver::karp_patching(matrix);
             } else {
                 throw std::runtime_error("nie znana opcja algorytmu 2_opt");
             }
@@ -138,6 +232,18 @@ auto choose_primary_algorithm(const arguments& opts) -> std::function<std::vecto
                 return solver::two_opt<solver::surroundings::swap>(matrix, choose_starting_path(matrix));
             };
 
+            return wrapper;
+        } else if (opts.algo_ == "balas_simonetti") {
+            std::size_t window { solver::balas_simonetti::default_window };
+            if (!opts.window_.empty()) {
+                std::stringstream ss { opts.window_ };
+                ss >> window;
+            }
+
+            auto wrapper = [choose_starting_path, window](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
+                return solver::balas_simonetti::solve(matrix, choose_starting_path(matrix), window);
+            };
+
             return wrapper;
         }
 
@@ -156,6 +262,177 @@ auto choose_algorithm(const arguments& opts) -> std::function<std::vector<std::s
     using namespace tsp::solver;
 
     auto fun = choose_primary_algorithm<T>(opts);
+    if (!opts.execute_aco_.empty()) {
+        aco::parameters params {};
+
+        if (!opts.aco_ants_.empty()) {
+            std::stringstream ss { opts.aco_ants_ };
+            ss >> params.ants_;
+        }
+
+        if (!opts.aco_iterations_.empty()) {
+            std::stringstream ss { opts.aco_iterations_ };
+            ss >> params.iterations_;
+        }
+
+        if (!opts.aco_time_.empty()) {
+            std::stringstream ss { opts.aco_time_ };
+            ss >> params.time_limit_;
+        }
+
+        if (!opts.aco_alpha_.empty()) {
+            std::stringstream ss { opts.aco_alpha_ };
+            ss >> params.alpha_;
+        }
+
+        if (!opts.aco_beta_.empty()) {
+            std::stringstream ss { opts.aco_beta_ };
+            ss >> params.beta_;
+        }
+
+        if (!opts.aco_rho_.empty()) {
+            std::stringstream ss { opts.aco_rho_ };
+            ss >> params.rho_;
+        }
+
+        if (!opts.aco_neighbours_.empty()) {
+            std::stringstream ss { opts.aco_neighbours_ };
+            ss >> params.neighbours_;
+        }
+
+        if (!opts.aco_threads_.empty()) {
+            std::stringstream ss { opts.aco_threads_ };
+            ss >> params.threads_;
+        }
+
+        params.polish_ = !opts.aco_no_polish_;
+
+        if (opts.execute_aco_ == "mmas") {
+            return [fun, params](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
+                return aco::solve(matrix, fun(matrix), params);
+            };
+        }
+
+        throw std::runtime_error { "nie znaleziono odpowiadajacego algo aco!" };
+    }
+    if (!opts.execute_annealing_.empty()) {
+        annealing::parameters params {};
+
+        if (opts.execute_annealing_ == "pt") {
+            params.replicas_ = 4;
+        } else if (opts.execute_annealing_ != "sa") {
+            throw std::runtime_error { "nie znaleziono odpowiadajacego algo annealing!" };
+        }
+
+        if (opts.sa_schedule_ == "linear") {
+            params.schedule_ = annealing::schedule::linear;
+        } else if (opts.sa_schedule_ == "lundy_mees") {
+            params.schedule_ = annealing::schedule::lundy_mees;
+        } else if (!opts.sa_schedule_.empty() && opts.sa_schedule_ != "geometric") {
+            throw std::runtime_error { "nie znany harmonogram chlodzenia \"" + opts.sa_schedule_ + "\"" };
+        }
+
+        if (!opts.sa_temperature_.empty()) {
+            std::stringstream ss { opts.sa_temperature_ };
+            ss >> params.initial_temperature_;
+        }
+
+        if (!opts.sa_ratio_.empty()) {
+            std::stringstream ss { opts.sa_ratio_ };
+            ss >> params.final_ratio_;
+        }
+
+        if (!opts.sa_epochs_.empty()) {
+            std::stringstream ss { opts.sa_epochs_ };
+            ss >> params.epochs_;
+        }
+
+        if (!opts.sa_epoch_length_.empty()) {
+            std::stringstream ss { opts.sa_epoch_length_ };
+            ss >> params.epoch_length_;
+        }
+
+        if (!opts.sa_time_.empty()) {
+            std::stringstream ss { opts.sa_time_ };
+            ss >> params.time_limit_;
+        }
+
+        if (!opts.sa_replicas_.empty()) {
+            std::stringstream ss { opts.sa_replicas_ };
+            ss >> params.replicas_;
+        }
+
+        if (!opts.sa_exchange_interval_.empty()) {
+            std::stringstream ss { opts.sa_exchange_interval_ };
+            ss >> params.exchange_interval_;
+        }
+
+        return [fun, params](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
+            return annealing::solve(matrix, fun(matrix), params);
+        };
+    }
+    if (!opts.execute_ils_.empty()) {
+        ils::parameters params {};
+
+        if (!opts.ils_iterations_.empty()) {
+            std::stringstream ss { opts.ils_iterations_ };
+            ss >> params.iterations_;
+        }
+
+        if (!opts.ils_time_.empty()) {
+            std::stringstream ss { opts.ils_time_ };
+            ss >> params.time_limit_;
+        }
+
+        if (!opts.ils_neighbours_.empty()) {
+            std::stringstream ss { opts.ils_neighbours_ };
+            ss >> params.neighbours_;
+        }
+
+        if (!opts.ils_kick_length_.empty()) {
+            std::stringstream ss { opts.ils_kick_length_ };
+            ss >> params.kick_length_;
+        }
+
+        if (opts.execute_ils_ == "ils") {
+            return [fun, params](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
+                return ils::solve(matrix, fun(matrix), params);
+            };
+        }
+
+        throw std::runtime_error { "nie znaleziono odpowiadajacego algo ils!" };
+    }
+    if (!opts.execute_gls_.empty()) {
+        gls::parameters params {};
+
+        if (!opts.gls_iterations_.empty()) {
+            std::stringstream ss { opts.gls_iterations_ };
+            ss >> params.iterations_;
+        }
+
+        if (!opts.gls_time_.empty()) {
+            std::stringstream ss { opts.gls_time_ };
+            ss >> params.time_limit_;
+        }
+
+        if (!opts.gls_neighbours_.empty()) {
+            std::stringstream ss { opts.gls_neighbours_ };
+            ss >> params.neighbours_;
+        }
+
+        if (!opts.gls_alpha_.empty()) {
+            std::stringstream ss { opts.gls_alpha_ };
+            ss >> params.alpha_;
+        }
+
+        if (opts.execute_gls_ == "gls") {
+            return [fun, params](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
+                return gls::solve(matrix, fun(matrix), params);
+            };
+        }
+
+        throw std::runtime_error { "nie znaleziono odpowiadajacego algo gls!" };
+    }
     if (!opts.execute_taboo_.empty()) {
         taboo_search::parameters params {};
 
@@ -218,6 +495,17 @@ auto choose_algorithm(const arguments& opts) -> std::function<std::vector<std::s
             ss >> params.selection_factor_;
         }
 
+        if (opts.selection_ == "sus") {
+            params.selection_ = genetic::selection_type::sus;
+        } else if (opts.selection_ == "tourney") {
+            params.selection_ = genetic::selection_type::tourney;
+        } else if (!opts.selection_.empty() && opts.selection_ != "roulette") {
+            throw std::runtime_error { "nieznana selekcja genetycznego!" };
+        }
+        params.rank_selection_ = opts.rank_selection_;
+        params.unique_ = !opts.allow_duplicates_;
+        params.diversity_ = opts.diversity_;
+
         if (!opts.arch_btw_.empty()) {
             std::stringstream ss { opts.arch_btw_ };
             ss >> params.elitysm_factor_;
@@ -243,9 +531,67 @@ auto choose_algorithm(const arguments& opts) -> std::function<std::vector<std::s
             ss >> params.enchance_chance_;
         }
 
+        if (!opts.enchance_window_.empty()) {
+            std::stringstream ss { opts.enchance_window_ };
+            ss >> params.enchance_window_;
+            if (params.enchance_window_ < 2 || params.enchance_window_ > balas_simonetti::max_window) {
+                throw std::runtime_error { "okno ulepszania genetycznego musi byc z zakresu [2, " + std::to_string(balas_simonetti::max_window) + "]!" };
+            }
+            params.improvement_ = genetic::improvement::balas_simonetti;
+        }
+
+        if (opts.improvement_ == "two_opt") {
+            params.improvement_ = genetic::improvement::two_opt;
+        } else if (opts.improvement_ == "or_opt") {
+            params.improvement_ = genetic::improvement::or_opt;
+        } else if (opts.improvement_ == "balas") {
+            params.improvement_ = genetic::improvement::balas_simonetti;
+        } else if (!opts.improvement_.empty()) {
+            throw std::runtime_error { "nieznane ulepszanie genetycznego!" };
+        }
+
+        if (!opts.enchance_moves_.empty()) {
+            std::stringstream ss { opts.enchance_moves_ };
+            ss >> params.enchance_moves_;
+        }
+
+        if (opts.crossover_ == "eax") {
+            params.crossover_ = genetic::crossover_type::eax;
+        } else if (!opts.crossover_.empty() && opts.crossover_ != "random") {
+            throw std::runtime_error { "nieznane krzyzowanie!" };
+        }
+
+        if (!opts.migration_interval_.empty()) {
+            std::stringstream ss { opts.migration_interval_ };
+            ss >> params.migration_interval_;
+        }
+
+        if (!opts.migrants_.empty()) {
+            std::stringstream ss { opts.migrants_ };
+            ss >> params.migrants_;
+        }
+
+        if (opts.topology_ == "random") {
+            params.topology_ = genetic::topology::random;
+        } else if (!opts.topology_.empty() && opts.topology_ != "ring") {
+            throw std::runtime_error { "nieznana topologia wysp!" };
+        }
+
+        if (opts.replacement_ == "worst") {
+            params.replacement_ = genetic::replacement::worst;
+        } else if (!opts.replacement_.empty() && opts.replacement_ != "tourney") {
+            throw std::runtime_error { "nieznana strategia zastepowania!" };
+        }
+
         std::random_device dev {};
         std::mt19937_64 rng { dev() };
-        if (opts.execute_genetic_ == "rand_oper") {
+        if (opts.execute_genetic_ == "islands") {
+            params.islands_ = true;
+        }
+        if (opts.execute_genetic_ == "steady") {
+            params.steady_state_ = true;
+        }
+        if (opts.execute_genetic_ == "rand_oper" || opts.execute_genetic_ == "islands" || opts.execute_genetic_ == "steady") {
             return [fun, params, rng](ds::heap_matrix<T> const& matrix) -> std::vector<std::size_t> {
                 // static_assert(!std::is_const<decltype(rng)>::value, "debil");
                 genetic::solver algorithm { params, rng };
@@ -325,6 +671,41 @@ auto choose_best(std::vector<std::pair<std::vector<std::size_t>, T>> const& resu
     return *mim_elem;
 }
 
+/**
+ * @brief hilbert bez dalszego pipeline'u -- wszystko na wspolrzednych, macierz n^2 dla milionow miast i tak by sie nie zmiescila
+ */
+void run_on_coordinates(const arguments& opts)
+{
+    const auto coords = load_coordinates(opts);
+
+    utils::time_it<std::chrono::milliseconds> timer {};
+
+    timer.set();
+    auto path = tsp::solver::space_filling::hilbert(coords, construction_threads(opts));
+    uint64_t execution_time = timer.measure();
+
+    auto value = tsp::solver::space_filling::calculate_value(coords, path);
+
+    std::cout << "obliczona trasa: " << path << "\n";
+    std::cout << "czas obliczania trasy: " << execution_time << "ms"
+              << "\n";
+    std::cout << "obliczona funkcja celu: " << value << "\n";
+
+    if (!opts.f_opt_.empty()) {
+        config::value_type fopt_value {};
+        std::stringstream ss { opts.f_opt_ };
+        ss >> fopt_value;
+
+        std::cout << "obliczona wartosc PRD: " << tsp::calculate_prd(value, fopt_value) << "\n";
+    }
+
+    if (!opts.python_.empty()) {
+        python_export::euclidean_visualization(
+            opts.problem_argument_, opts.python_,
+            export_info<config::value_type> { path, execution_time, value });
+    }
+}
+
 int main(int argc, char** argv)
 {
     // std::random_device dev {};
@@ -355,6 +736,12 @@ int main(int argc, char** argv)
         prd_printer::start(fopt_value);
     }
 
+    if (opts.algo_ == "hilbert" && opts.execute_taboo_.empty() && opts.execute_genetic_.empty() && opts.execute_ils_.empty() && opts.execute_annealing_.empty()
+        && opts.execute_aco_.empty() && opts.execute_gls_.empty() && !opts.print_matrix_ && opts.generate_file_.empty()) {
+        run_on_coordinates(opts);
+        return 0;
+    }
+
     const auto& matrix = initialize_matrix<config::value_type>(opts);
     if (opts.print_matrix_) {
         std::cout << "macierz odleglosci: " << matrix << "\n";
@@ -368,6 +755,17 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    std::unique_ptr<tsp::solver::lower_bound::engine> bound_engine {};
+    if (opts.gap_ || !opts.gap_epsilon_.empty()) {
+        double epsilon { -1. };
+        if (!opts.gap_epsilon_.empty()) {
+            std::stringstream ss { opts.gap_epsilon_ };
+            ss >> epsilon;
+        }
+
+        bound_engine = std::make_unique<tsp::solver::lower_bound::engine>(matrix, epsilon);
+    }
+
     const auto algorithm = choose_algorithm<config::value_type>(opts);
 
     utils::time_it<std::chrono::milliseconds> timer {};
@@ -378,6 +776,10 @@ int main(int argc, char** argv)
     auto results = runner(matrix);
     uint64_t execution_time = timer.measure();
 
+    if (bound_engine) {
+        bound_engine->finish();
+    }
+
     if (results.size() > 1) {
         std::cout << "szczegolowe wartosci dla threadow:\n";
 
@@ -404,6 +806,11 @@ int main(int argc, char** argv)
         prd_printer::stop();
     }
 
+    if (bound_engine) {
+        std::cout << "dolne ograniczenie: " << bound_engine->value() << "\n";
+        std::cout << "obliczona luka do dolnego ograniczenia: " << bound_engine->gap(value) << "%\n";
+    }
+
     if (!opts.python_.empty() && opts.problem_ == "file") {
         python_export::euclidean_visualization(
             opts.problem_argument_, opts.python_,
@@ -16,17 +16,38 @@
 
 namespace tsp_data {
 
-namespace parsing {
+/**
+ * @brief wspolrzedne miast z pliku EUC_2D -- dla algorytmow ktore nie potrzebuja (albo nie moga zbudowac) macierzy odleglosci
+ */
+struct coordinates {
+    std::vector<double> xs {};
+    std::vector<double> ys {};
+
+    auto size() const -> std::size_t
+    {
+        return xs.size();
+    }
+
+    /**
+     * @brief odleglosc zaokraglona tak samo jak przy budowaniu macierzy (parsing::euclidean)
+     */
     template <typename ValueType>
-    void euclidean(std::istream& ss, ds::heap_matrix<ValueType>& matrix)
+    auto distance(std::size_t from, std::size_t to) const -> ValueType
     {
-        auto size = matrix.size();
+        auto dx = xs[to] - xs[from];
+        auto dy = ys[to] - ys[from];
 
-        std::vector<double> xs {};
-        std::vector<double> ys {};
+        return static_cast<ValueType>(std::sqrt(dx * dx + dy * dy) + 0.5);
+    }
+};
 
-        xs.reserve(size);
-        ys.reserve(size);
+namespace parsing {
+    inline auto coordinates(std::istream& ss, uint64_t size) -> tsp_data::coordinates
+    {
+        tsp_data::coordinates coords {};
+
+        coords.xs.reserve(size);
+        coords.ys.reserve(size);
 
         for (decltype(size) i = 0; i < size; ++i) {
             uint64_t id {};
@@ -35,18 +56,23 @@ namespace parsing {
             ss >> id >> x >> y;
             // jak pokolei id to moge je olac
 
-            xs.push_back(x);
-            ys.push_back(y);
+            coords.xs.push_back(x);
+            coords.ys.push_back(y);
         }
 
-        for (decltype(size) to = 0; to < size; ++to) {
-            for (decltype(size) from = 0; from < size; ++from) {
-                auto dx = xs[to] - xs[from];
-                auto dy = ys[to] - ys[from];
+        return coords;
+    }
 
-                ValueType distance { static_cast<ValueType>(std::sqrt(dx * dx + dy * dy) + 0.5) };
+    template <typename ValueType>
+    void euclidean(std::istream& ss, ds::heap_matrix<ValueType>& matrix)
+    {
+        auto size = matrix.size();
+
+        const tsp_data::coordinates coords = coordinates(ss, size);
 
-                matrix.at(from, to) = distance;
+        for (decltype(size) to = 0; to < size; ++to) {
+            for (decltype(size) from = 0; from < size; ++from) {
+                matrix.at(from, to) = coords.distance<ValueType>(from, to);
                 // matrix.at(to, from) = distance; // myslenie jest trudne
             }
         }
@@ -212,4 +238,16 @@ auto parse(std::istream& ss) -> ds::heap_matrix<ValueType>
 
     return matrix;
 }
+
+template <typename ValueType>
+auto parse_coordinates(std::istream& ss) -> coordinates
+{
+    file_info info = parse_metadata<ValueType>(ss);
+
+    if (info.type != file_info::format_type::euc2d) {
+        throw std::runtime_error { "parse:: wspolrzedne sa tylko w plikach EUC_2D" };
+    }
+
+    return parsing::coordinates(ss, info.dimension);
+}
 }
\ No newline at end of file
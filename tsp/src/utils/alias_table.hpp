@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief losowanie indeksu z wagami metoda Walkera: budowa O(n), losowanie O(1) -- jedna liczba losowa wybiera kolumne
+ * i prog w niej. draw() jest const, wiec po zbudowaniu wiele watkow moze losowac naraz, kazdy swoim generatorem
+ * bufory zostaja miedzy kolejnymi build(), wiec przebudowa co pokolenie nie allokuje
+ */
+class alias_table {
+    std::vector<double> threshold_ {};
+    std::vector<uint32_t> alias_ {};
+    std::vector<uint32_t> small_ {};
+    std::vector<uint32_t> large_ {};
+
+public:
+    /**
+     * @param weights nieujemne, nie wszystkie zerowe -- jak suma jest 0, losowanie jest rownomierne
+     */
+    void build(std::span<const double> weights)
+    {
+        const auto size = weights.size();
+        threshold_.resize(size);
+        alias_.resize(size);
+        small_.clear();
+        large_.clear();
+
+        double sum {};
+        for (auto w : weights) {
+            sum += w;
+        }
+
+        const auto scale = sum > 0. ? static_cast<double>(size) / sum : 0.;
+        for (std::size_t i {}; i < size; ++i) {
+            threshold_[i] = sum > 0. ? weights[i] * scale : 1.;
+            alias_[i] = static_cast<uint32_t>(i);
+            (threshold_[i] < 1. ? small_ : large_).push_back(static_cast<uint32_t>(i));
+        }
+
+        // kolumna z niedomiarem jest dopelniana nadmiarem innej
+        while (!small_.empty() && !large_.empty()) {
+            const auto s = small_.back();
+            small_.pop_back();
+            const auto l = large_.back();
+
+            alias_[s] = l;
+            threshold_[l] -= 1. - threshold_[s];
+            if (threshold_[l] < 1.) {
+                large_.pop_back();
+                small_.push_back(l);
+            }
+        }
+
+        // reszta to bledy zaokraglen -- pelne kolumny
+        for (auto i : small_) {
+            threshold_[i] = 1.;
+        }
+        for (auto i : large_) {
+            threshold_[i] = 1.;
+        }
+    }
+
+    auto size() const -> std::size_t
+    {
+        return threshold_.size();
+    }
+
+    template <typename Rng>
+    auto draw(Rng& rng) const -> uint32_t
+    {
+        // czesc calkowita to kolumna, ulamkowa to prog -- jedna liczba losowa
+        const auto u = std::uniform_real_distribution<double>(0., static_cast<double>(threshold_.size()))(rng);
+        const auto column = std::min(static_cast<std::size_t>(u), threshold_.size() - 1);
+        return u - static_cast<double>(column) < threshold_[column] ? static_cast<uint32_t>(column) : alias_[column];
+    }
+};
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+
+namespace utils {
+
+/**
+ * @brief atomowe target = min(target, value) -- std::atomic nie ma fetch_min przed c++26
+ *
+ * @return true jezeli value bylo mniejsze i zostalo zapisane
+ */
+template <typename T>
+inline auto atomic_fetch_min(std::atomic<T>& target, T value) -> bool
+{
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current) {
+        if (target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief atomowe target = max(target, value)
+ *
+ * @return true jezeli value bylo wieksze i zostalo zapisane
+ */
+template <typename T>
+inline auto atomic_fetch_max(std::atomic<T>& target, T value) -> bool
+{
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current) {
+        if (target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
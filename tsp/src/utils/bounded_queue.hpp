@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+
+/**
+ * @brief ograniczona kolejka bez blokad dla wielu producentow i konsumentow (Vyukov) -- kazda komorka ma numer
+ * sekwencji, ktory mowi czy mozna do niej pisac czy z niej czytac, a pozycje sa rezerwowane CAS-em
+ *
+ * elementy nie sa przenoszone: zapis i odczyt dostaja referencje na komorke, wiec komorki z prealokowanymi buforami
+ * (np wektor na trase) przechodza przez kolejke bez allokacji. pojemnosc zaokraglana w gore do potegi 2
+ */
+template <typename T>
+class bounded_queue {
+    struct cell {
+        std::atomic<std::size_t> sequence_ {};
+        T value_ {};
+    };
+
+    std::size_t mask_ {};
+    std::unique_ptr<cell[]> cells_ {};
+
+    alignas(64) std::atomic<std::size_t> enqueue_ { 0 };
+    alignas(64) std::atomic<std::size_t> dequeue_ { 0 };
+
+public:
+    /**
+     * @param init wolane raz dla kazdej komorki -- np zeby zarezerwowac pamiec
+     */
+    template <typename Init>
+    bounded_queue(std::size_t capacity, Init init)
+        : mask_ { std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1 }
+        , cells_ { std::make_unique<cell[]>(mask_ + 1) }
+    {
+        for (std::size_t i {}; i <= mask_; ++i) {
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+            init(cells_[i].value_);
+        }
+    }
+
+    explicit bounded_queue(std::size_t capacity)
+        : bounded_queue(capacity, [](T&) { })
+    {
+    }
+
+    /**
+     * @param write zapisuje element do komorki
+     * @return false jezeli kolejka jest pelna -- nic nie zostalo zapisane
+     */
+    template <typename Write>
+    auto try_push(Write write) -> bool
+    {
+        auto position = enqueue_.load(std::memory_order_relaxed);
+        while (true) {
+            auto& c = cells_[position & mask_];
+            const auto sequence = c.sequence_.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0) {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    write(c.value_);
+                    c.sequence_.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @param read dostaje element z komorki
+     * @return false jezeli kolejka jest pusta
+     */
+    template <typename Read>
+    auto try_pop(Read read) -> bool
+    {
+        auto position = dequeue_.load(std::memory_order_relaxed);
+        while (true) {
+            auto& c = cells_[position & mask_];
+            const auto sequence = c.sequence_.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+            if (difference == 0) {
+                if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    read(c.value_);
+                    c.sequence_.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+}
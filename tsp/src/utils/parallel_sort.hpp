@@ -0,0 +1,77 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief sort na puli watkow: kazdy thread sortuje swoj kawalek, potem kawalki sa scalane parami (tez rownolegle)
+ *
+ * @param threads 0 -> wszystkie dostepne
+ */
+template <typename Iter, typename Less>
+void parallel_sort(Iter begin, Iter end, Less less, std::size_t threads = 0)
+{
+    const std::size_t size = std::distance(begin, end);
+
+    threads = threads == 0 ? std::thread::hardware_concurrency() : threads;
+    // ponizej tego nie oplaca sie budzic threadow
+    constexpr std::size_t min_chunk = 1 << 14;
+    threads = std::max<std::size_t>(1, std::min(threads, size / min_chunk));
+
+    if (threads == 1) {
+        std::sort(begin, end, less);
+        return;
+    }
+
+    std::vector<Iter> bounds {};
+    bounds.reserve(threads + 1);
+    for (std::size_t chunk {}; chunk <= threads; ++chunk) {
+        bounds.push_back(begin + size * chunk / threads);
+    }
+
+    thread_pool pool { threads };
+    std::vector<std::future<void>> futures {};
+    futures.reserve(threads);
+
+    for (std::size_t chunk {}; chunk < threads; ++chunk) {
+        futures.push_back(pool.queue([first = bounds[chunk], last = bounds[chunk + 1], &less]() {
+            std::sort(first, last, less);
+        }));
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    while (bounds.size() > 2) {
+        futures.clear();
+        std::vector<Iter> merged {};
+        merged.reserve(bounds.size() / 2 + 1);
+
+        std::size_t chunk {};
+        for (; chunk + 2 < bounds.size(); chunk += 2) {
+            merged.push_back(bounds[chunk]);
+            futures.push_back(pool.queue([first = bounds[chunk], middle = bounds[chunk + 1], last = bounds[chunk + 2], &less]() {
+                std::inplace_merge(first, middle, last, less);
+            }));
+        }
+        // nieparzysty ostatni kawalek czeka na nastepna runde
+        for (; chunk < bounds.size(); ++chunk) {
+            merged.push_back(bounds[chunk]);
+        }
+
+        for (auto& future : futures) {
+            future.wait();
+        }
+        bounds = std::move(merged);
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief kolejki zadan z kradzieza: kazdy worker bierze ze swojego konca (LIFO -- w glab),
+ * a jak nic nie ma to kradnie najstarsze zadanie z poczatku cudzej kolejki (zwykle najwiekszy kawalek pracy)
+ *
+ * pending() liczy zadania wrzucone i jeszcze nie zakonczone przez done(), wiec 0 oznacza koniec calej pracy
+ * (zadanie dodaje dzieci zanim samo zostanie oznaczone jako zrobione)
+ */
+template <typename Task>
+class work_stealing_queues {
+    struct worker_queue {
+        std::mutex m {};
+        std::deque<Task> tasks {};
+    };
+
+    std::vector<worker_queue> queues_;
+    std::atomic<int64_t> pending_ { 0 };
+
+public:
+    explicit work_stealing_queues(std::size_t workers)
+        : queues_(workers)
+    {
+    }
+
+    void push(std::size_t worker, Task task)
+    {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> l(queues_[worker].m);
+        queues_[worker].tasks.push_back(std::move(task));
+    }
+
+    auto pop(std::size_t worker) -> std::optional<Task>
+    {
+        {
+            auto& own = queues_[worker];
+            std::unique_lock<std::mutex> l(own.m);
+            if (!own.tasks.empty()) {
+                Task task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return task;
+            }
+        }
+
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            auto& victim = queues_[(worker + i) % queues_.size()];
+            std::unique_lock<std::mutex> l(victim.m);
+            if (!victim.tasks.empty()) {
+                Task task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+
+        return {};
+    }
+
+    void done()
+    {
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    auto pending() const -> int64_t
+    {
+        return pending_.load(std::memory_order_acquire);
+    }
+};
+
+}
@@ -0,0 +1,49 @@
+#include "../src/utils/alias_table.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+int main()
+{
+    std::mt19937_64 rng { 3 };
+    utils::alias_table table {};
+
+    // ta sama tablica przebudowywana -- jak w kolejnych pokoleniach
+    for (const std::vector<double>& weights : std::vector<std::vector<double>> {
+             { 1. },
+             { 1., 1., 1., 1. },
+             { 0., 5., 0., 1., 4. },
+             { 1000., 1., 1., 1., 1., 1., 1., 1. },
+             { 0., 0., 0. },
+         }) {
+        table.build(weights);
+        assert(table.size() == weights.size());
+
+        double sum {};
+        for (auto w : weights) {
+            sum += w;
+        }
+
+        constexpr std::size_t draws = 200000;
+        std::vector<std::size_t> counts(weights.size());
+        for (std::size_t i {}; i < draws; ++i) {
+            const auto drawn = table.draw(rng);
+            assert(drawn < weights.size());
+            ++counts[drawn];
+        }
+
+        for (std::size_t i {}; i < weights.size(); ++i) {
+            const auto expected = sum > 0. ? weights[i] / sum : 1. / static_cast<double>(weights.size());
+            const auto observed = static_cast<double>(counts[i]) / static_cast<double>(draws);
+            if (expected == 0.) {
+                assert(counts[i] == 0);
+            }
+            assert(std::abs(observed - expected) < 0.01);
+        }
+    }
+
+    return 0;
+}
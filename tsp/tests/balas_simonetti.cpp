@@ -0,0 +1,66 @@
+#include "../src/solver/balas_simonetti.hpp"
+#include "../src/tsp_data/randomized.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// pelny przeglad tras, w ktorych miasto z pozycji i zostaje przed miastem z pozycji j >= i + k
+auto brute_force(const ds::heap_matrix<config::value_type>& matrix, const config::path_type& path, std::size_t k) -> config::value_type
+{
+    const auto size = matrix.size();
+    std::vector<std::size_t> order(size - 1);
+    std::iota(order.begin(), order.end(), 1);
+
+    auto best = std::numeric_limits<config::value_type>::max();
+    do {
+        std::vector<std::size_t> position(size, 0);
+        for (std::size_t i {}; i < order.size(); ++i) {
+            position[order[i]] = i + 1;
+        }
+
+        bool allowed = true;
+        for (std::size_t i {}; i < size && allowed; ++i) {
+            for (std::size_t j = i + k; j < size && allowed; ++j) {
+                allowed = position[i] < position[j];
+            }
+        }
+        if (!allowed) {
+            continue;
+        }
+
+        config::path_type candidate { path[0] };
+        for (auto i : order) {
+            candidate.push_back(path[i]);
+        }
+        candidate.push_back(path[0]);
+        best = std::min(best, tsp::calculate_value(matrix, candidate));
+    } while (std::next_permutation(order.begin(), order.end()));
+
+    return best;
+}
+
+int main()
+{
+    std::mt19937 rng { 2137 };
+
+    for (std::size_t size = 5; size <= 9; ++size) {
+        for (std::size_t k = 2; k <= 5; ++k) {
+            for (auto const& matrix : { tsp_data::randomized_atsp<config::value_type>(size, 1, 100),
+                     tsp_data::randomized_tsp<config::value_type>(size, 1, 100) }) {
+                config::path_type path(size);
+                std::iota(path.begin(), path.end(), 0);
+                std::shuffle(path.begin() + 1, path.end(), rng);
+                path.push_back(path[0]);
+
+                auto improved = path;
+                auto value = tsp::solver::balas_simonetti::improve(matrix, improved, k);
+                assert(value == tsp::calculate_value(matrix, improved));
+                assert(value == brute_force(matrix, path, k));
+            }
+        }
+    }
+}
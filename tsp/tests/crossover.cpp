@@ -0,0 +1,97 @@
+#include "../src/solver/genetic.hpp"
+#include "../src/tsp_data/randomized.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace tsp::solver::genetic;
+using rng_type = std::mt19937_64;
+using crossover_fn = void (*)(const_chromosome, const_chromosome, chromosome, workspace<rng_type>&);
+
+auto is_permutation(const std::vector<city_type>& child) -> bool
+{
+    std::vector<city_type> sorted = child;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i {}; i < sorted.size(); ++i) {
+        if (sorted[i] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    rng_type rng { 7 };
+    const std::array<crossover_fn, 4> crossovers = {
+        crossover_operator::order<rng_type>::crossover,
+        crossover_operator::partially_mapped<rng_type>::crossover,
+        crossover_operator::cycle<rng_type>::crossover,
+        crossover_operator::edge_recombination<rng_type>::crossover,
+    };
+
+    for (std::size_t size : { 2, 3, 5, 17, 100 }) {
+        // jeden workspace na wszystkie wywolania -- znaczniki z poprzednich nie moga przeciekac
+        workspace<rng_type> ws { size, rng_type { 11 } };
+        std::vector<city_type> a(size);
+        std::vector<city_type> b(size);
+        std::vector<city_type> child(size);
+        std::iota(a.begin(), a.end(), 0);
+        std::iota(b.begin(), b.end(), 0);
+
+        for (int round {}; round < 200; ++round) {
+            std::shuffle(a.begin(), a.end(), rng);
+            std::shuffle(b.begin(), b.end(), rng);
+
+            for (std::size_t c {}; c < crossovers.size(); ++c) {
+                crossovers[c](a, b, child, ws);
+                assert(is_permutation(child));
+            }
+
+            // cycle: kazde miasto na pozycji z ktoregos rodzica
+            crossover_operator::cycle<rng_type>::crossover(a, b, child, ws);
+            for (std::size_t i {}; i < size; ++i) {
+                assert(child[i] == a[i] || child[i] == b[i]);
+            }
+
+            // edge recombination: z tych samych rodzicow ten sam cykl
+            crossover_operator::edge_recombination<rng_type>::crossover(a, a, child, ws);
+            const auto start = std::find(a.begin(), a.end(), child[0]) - a.begin();
+            const bool forward = size < 3 || child[1] == a[(start + 1) % size];
+            for (std::size_t i {}; i < size; ++i) {
+                assert(child[i] == a[forward ? (start + i) % size : (start + size - i) % size]);
+            }
+        }
+
+        // EAX: permutacja dla STSP i ATSP, z identycznych rodzicow kopia
+        if (size < 5) {
+            continue;
+        }
+        for (bool symmetric : { true, false }) {
+            auto matrix = symmetric ? tsp_data::randomized_tsp<config::value_type>(size, 1, 100) : tsp_data::randomized_atsp<config::value_type>(size, 1, 100);
+            const tsp::solver::eax::context context { matrix, 5, symmetric };
+            ws.eax_context_ = &context;
+
+            for (int round {}; round < 200; ++round) {
+                std::shuffle(a.begin(), a.end(), rng);
+                std::shuffle(b.begin(), b.end(), rng);
+
+                const auto delta = tsp::solver::eax::crossover(a, b, child, context, ws.eax_, rng);
+                assert(is_permutation(child));
+                assert(static_cast<int64_t>(calculate_value(matrix, const_chromosome { child })) - static_cast<int64_t>(calculate_value(matrix, const_chromosome { a })) == delta);
+
+                crossover_operator::edge_assembly<rng_type>::crossover(a, b, child, ws);
+                assert(is_permutation(child));
+
+                crossover_operator::edge_assembly<rng_type>::crossover(a, a, child, ws);
+                assert(child == a);
+            }
+        }
+    }
+
+    return 0;
+}
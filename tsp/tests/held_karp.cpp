@@ -0,0 +1,78 @@
+#include "../src/solver/branch_and_bound.hpp"
+#include "../src/solver/held_karp.hpp"
+#include "../src/solver/patching.hpp"
+#include "../src/solver/solver.hpp"
+#include "../src/tsp_data/randomized.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// tsp.cpp definiuje print, test nie drukuje PRD
+void prd_printer::print(uint64_t, config::value_type) { }
+
+// pelny przeglad permutacji z ustalonym startem -- wzorzec dla malych n
+auto brute_force(const ds::heap_matrix<config::value_type>& matrix) -> config::value_type
+{
+    std::vector<std::size_t> order(matrix.size() - 1);
+    std::iota(order.begin(), order.end(), 1);
+
+    auto best = std::numeric_limits<config::value_type>::max();
+    do {
+        config::path_type path { 0 };
+        path.insert(path.end(), order.begin(), order.end());
+        path.push_back(0);
+        best = std::min(best, tsp::calculate_value(matrix, path));
+    } while (std::next_permutation(order.begin(), order.end()));
+
+    return best;
+}
+
+void check_path(const config::path_type& path, std::size_t size)
+{
+    assert(path.size() == size + 1);
+    assert(path.front() == path.back());
+
+    std::vector<std::size_t> cities(path.begin(), path.end() - 1);
+    std::sort(cities.begin(), cities.end());
+    for (std::size_t i {}; i < size; ++i) {
+        assert(cities[i] == i);
+    }
+}
+
+int main()
+{
+    for (uint64_t size = 3; size <= 9; ++size) {
+        for (int round {}; round < 3; ++round) {
+            for (auto const& matrix : { tsp_data::randomized_atsp<config::value_type>(size, 5, 100),
+                     tsp_data::randomized_tsp<config::value_type>(size, 5, 100) }) {
+                auto optimal = tsp::solver::held_karp::solve(matrix, 1);
+                check_path(optimal, size);
+
+                auto optimum = tsp::calculate_value(matrix, optimal);
+                assert(optimum == brute_force(matrix));
+
+                // zadna heurystyka nie moze zejsc ponizej optimum -- PRD >= 0
+                assert(tsp::calculate_prd(tsp::calculate_value(matrix, tsp::solver::nearest_ext(matrix)), optimum) >= 0.);
+                assert(tsp::calculate_prd(tsp::calculate_value(matrix, tsp::solver::karp_patching(matrix)), optimum) >= 0.);
+            }
+        }
+    }
+
+    // branch and bound tez jest dokladny -- musi trafic w optimum Held-Karpa
+    for (uint64_t size = 4; size <= 13; ++size) {
+        for (auto const& matrix : { tsp_data::randomized_atsp<config::value_type>(size, 5, 100),
+                 tsp_data::randomized_tsp<config::value_type>(size, 5, 100) }) {
+            auto path = tsp::solver::branch_and_bound::solve(matrix, { .threads_ = 4 });
+            check_path(path, size);
+            assert(tsp::calculate_value(matrix, path) == tsp::calculate_value(matrix, tsp::solver::held_karp::solve(matrix, 1)));
+        }
+    }
+
+    // sciezka rownolegla (od 12 miast) musi dac to samo co sekwencyjna
+    auto matrix = tsp_data::randomized_atsp<config::value_type>(14, 5, 100);
+    assert(tsp::calculate_value(matrix, tsp::solver::held_karp::solve(matrix, 4))
+        == tsp::calculate_value(matrix, tsp::solver::held_karp::solve(matrix, 1)));
+}
@@ -0,0 +1,50 @@
+#include "../src/solver/genetic.hpp"
+#include "../src/tsp_data/randomized.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace tsp::solver::genetic;
+using rng_type = std::mt19937_64;
+using mutation_fn = delta_type (*)(chromosome, rng_type&, mutation_operator::delta_context const*);
+
+int main()
+{
+    rng_type rng { 13 };
+    const std::array<mutation_fn, 3> mutations = {
+        mutation_operator::twor_swap::mutate,
+        mutation_operator::centre_inverse::mutate,
+        mutation_operator::reverse_sequence::mutate,
+    };
+
+    // zmiana kosztu z mutacji musi sie zgadzac z pelna ocena -- dla ATSP przez sumy prefiksowe rodzica
+    for (std::size_t size : { 2, 3, 5, 17, 100 }) {
+        for (bool symmetric : { true, false }) {
+            auto matrix = symmetric ? tsp_data::randomized_tsp<config::value_type>(size, 1, 100) : tsp_data::randomized_atsp<config::value_type>(size, 1, 100);
+            population parents { 1, size, symmetric };
+            const mutation_operator::delta_context context { matrix, symmetric, &parents, 0 };
+
+            std::vector<city_type> genes(size);
+            std::vector<city_type> child(size);
+            std::iota(genes.begin(), genes.end(), 0);
+
+            for (int round {}; round < 200; ++round) {
+                std::shuffle(genes.begin(), genes.end(), rng);
+                const auto parent_fitness = calculate_value(matrix, const_chromosome { genes });
+                parents.assign(0, genes, parent_fitness);
+
+                for (auto mutate : mutations) {
+                    std::copy(genes.begin(), genes.end(), child.begin());
+                    const auto delta = mutate(child, rng, &context);
+                    assert(static_cast<int64_t>(calculate_value(matrix, const_chromosome { child })) - static_cast<int64_t>(parent_fitness) == delta);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
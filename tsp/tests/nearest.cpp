@@ -0,0 +1,56 @@
+#include "../src/solver/solver.hpp"
+#include "../src/tsp_data/randomized.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+// poprzednia implementacja (std::set) -- nowa musi dawac identyczne trasy, lacznie z remisami
+auto reference_nearest(const ds::heap_matrix<config::value_type>& matrix, const std::size_t starting_position) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> path {};
+    path.push_back(starting_position);
+    std::set<std::size_t> already_visited {};
+    already_visited.insert(starting_position);
+
+    auto position = starting_position;
+    for (size_t num { 1 }; num < matrix.size(); ++num) {
+        std::optional<config::value_type> closest_value {};
+        std::size_t closest_position {};
+        for (std::size_t i {}; i < matrix.size(); ++i) {
+            if (i == position || already_visited.find(i) != already_visited.end()) {
+                continue;
+            }
+
+            auto value = matrix.at(position, i);
+            if (!closest_value || (closest_value && value < *closest_value)) {
+                closest_value = value;
+                closest_position = i;
+            }
+        }
+
+        path.push_back(closest_position);
+        already_visited.insert(closest_position);
+        position = closest_position;
+    }
+
+    path.push_back(starting_position);
+
+    return path;
+}
+
+int main()
+{
+    // waski zakres wag -> duzo remisow
+    for (uint64_t size : { 1, 2, 3, 17, 64 }) {
+        auto atsp = tsp_data::randomized_atsp<config::value_type>(size, 5, 8);
+        auto tsp = tsp_data::randomized_tsp<config::value_type>(size, 5, 8);
+
+        for (std::size_t start {}; start < size; ++start) {
+            assert(tsp::solver::nearest(atsp, start) == reference_nearest(atsp, start));
+            assert(tsp::solver::nearest(tsp, start) == reference_nearest(tsp, start));
+        }
+    }
+}